@@ -0,0 +1,239 @@
+/* MyGAL
+ * Copyright (C) 2019 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// STL
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+/**
+ * \brief Namespace of MyGAL
+ */
+namespace mygal
+{
+
+/**
+ * \brief Chunked storage with stable addresses
+ *
+ * Elements are stored in chunks of `ChunkSize` elements that are never
+ * moved nor freed before the arena itself, so pointers to the elements
+ * remain valid for the whole lifetime of the arena. Several chunks can
+ * share the same allocation: a reservation is done with a single
+ * allocation and everything is released at once when the arena is destroyed.
+ *
+ * Erased elements are only marked as such and skipped during iteration,
+ * their memory is not reused.
+ *
+ * \tparam T Type of the elements, must be default constructible
+ * \tparam ChunkSize Number of elements per chunk, must be a power of two
+ */
+template<typename T, std::size_t ChunkSize = 1024>
+class Arena
+{
+    static_assert(ChunkSize > 0 && (ChunkSize & (ChunkSize - 1)) == 0, "ChunkSize must be a power of two");
+
+public:
+    /**
+     * \brief Forward iterator over the elements that have not been erased
+     */
+    class ConstIterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        ConstIterator(const Arena* arena, std::size_t i) : mArena(arena), mIndex(i)
+        {
+            skipErased();
+        }
+
+        reference operator*() const
+        {
+            return (*mArena)[mIndex];
+        }
+
+        pointer operator->() const
+        {
+            return &(*mArena)[mIndex];
+        }
+
+        ConstIterator& operator++()
+        {
+            ++mIndex;
+            skipErased();
+            return *this;
+        }
+
+        ConstIterator operator++(int)
+        {
+            auto it = *this;
+            ++(*this);
+            return it;
+        }
+
+        bool operator==(const ConstIterator& other) const
+        {
+            return mIndex == other.mIndex;
+        }
+
+        bool operator!=(const ConstIterator& other) const
+        {
+            return mIndex != other.mIndex;
+        }
+
+    private:
+        const Arena* mArena;
+        std::size_t mIndex;
+
+        void skipErased()
+        {
+            while (mIndex < mArena->mNbSlots && mArena->mErased[mIndex])
+                ++mIndex;
+        }
+    };
+
+    Arena() = default;
+
+    // Remove copy operations
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    // Move operations
+
+    Arena(Arena&& other) : mBlocks(std::move(other.mBlocks)), mChunks(std::move(other.mChunks)),
+        mErased(std::move(other.mErased)), mNbSlots(std::exchange(other.mNbSlots, 0)),
+        mNbErased(std::exchange(other.mNbErased, 0))
+    {
+
+    }
+
+    Arena& operator=(Arena&& other)
+    {
+        mBlocks = std::move(other.mBlocks);
+        mChunks = std::move(other.mChunks);
+        mErased = std::move(other.mErased);
+        mNbSlots = std::exchange(other.mNbSlots, 0);
+        mNbErased = std::exchange(other.mNbErased, 0);
+        return *this;
+    }
+
+    // Accessors
+
+    /**
+     * \brief Get the number of elements that have not been erased
+     */
+    std::size_t size() const
+    {
+        return mNbSlots - mNbErased;
+    }
+
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    /**
+     * \brief Get the number of elements that can be created without allocating
+     */
+    std::size_t capacity() const
+    {
+        return mChunks.size() * ChunkSize;
+    }
+
+    T& operator[](std::size_t i)
+    {
+        return mChunks[i / ChunkSize][i % ChunkSize];
+    }
+
+    const T& operator[](std::size_t i) const
+    {
+        return mChunks[i / ChunkSize][i % ChunkSize];
+    }
+
+    ConstIterator begin() const
+    {
+        return ConstIterator(this, 0);
+    }
+
+    ConstIterator end() const
+    {
+        return ConstIterator(this, mNbSlots);
+    }
+
+    // Operations
+
+    /**
+     * \brief Make sure that `n` elements can be created without allocating
+     *
+     * The missing chunks are obtained with a single allocation.
+     */
+    void reserve(std::size_t n)
+    {
+        if (n > capacity())
+            allocate((n - capacity() + ChunkSize - 1) / ChunkSize);
+        mErased.reserve(n);
+    }
+
+    /**
+     * \brief Create a default constructed element
+     *
+     * \return Index of the new element
+     */
+    std::size_t create()
+    {
+        if (mNbSlots == capacity())
+            allocate(1);
+        mErased.push_back(false);
+        return mNbSlots++;
+    }
+
+    /**
+     * \brief Erase an element, its address is not reused
+     */
+    void erase(std::size_t i)
+    {
+        if (!mErased[i])
+        {
+            mErased[i] = true;
+            ++mNbErased;
+        }
+    }
+
+private:
+    std::vector<std::unique_ptr<T[]>> mBlocks; /**< Allocations owned by the arena */
+    std::vector<T*> mChunks; /**< Start of each chunk, chunks may share a block */
+    std::vector<bool> mErased;
+    std::size_t mNbSlots = 0;
+    std::size_t mNbErased = 0;
+
+    void allocate(std::size_t nbChunks)
+    {
+        mBlocks.emplace_back(new T[nbChunks * ChunkSize]);
+        for (auto i = std::size_t(0); i < nbChunks; ++i)
+            mChunks.push_back(mBlocks.back().get() + i * ChunkSize);
+    }
+};
+
+}
@@ -21,6 +21,7 @@
 #include "Vector2.h"
 #include "Diagram.h"
 #include "Arc.h"
+#include "MemoryPool.h"
 #include "util.h"
 
 /**
@@ -33,7 +34,12 @@ template<typename T>
 class Beachline
 {
 public:
-    Beachline() : mNil(new Arc<T>), mRoot(mNil)
+    /**
+     * \brief Constructor of Beachline
+     *
+     * \param arcPool Pool from which the arcs are allocated, it must outlive the beachline
+     */
+    explicit Beachline(MemoryPool<Arc<T>>& arcPool) : mArcPool(&arcPool), mNil(new Arc<T>), mRoot(mNil)
     {
         mNil->color = Arc<T>::Color::Black; 
     }
@@ -53,6 +59,7 @@ public:
 
     Beachline(Beachline&& other)
     {
+        mArcPool = other.mArcPool;
         mNil = other.mNil;
         mRoot = other.mRoot;
         other.mNil = nullptr;
@@ -63,15 +70,17 @@ public:
     {
         free(mRoot);
         delete mNil;
+        mArcPool = other.mArcPool;
         mNil = other.mNil;
         mRoot = other.mRoot;
         other.mNil = nullptr;
         other.mRoot = nullptr;
+        return *this;
     }
 
     Arc<T>* createArc(typename Diagram<T>::Site* site, typename Arc<T>::Side side = Arc<T>::Side::Left)
     {
-        return new Arc<T>{mNil, mNil, mNil, site, nullptr, nullptr, nullptr, mNil, mNil, Arc<T>::Color::Red, side};
+        return mArcPool->create(mNil, mNil, mNil, site, nullptr, nullptr, nullptr, mNil, mNil, Arc<T>::Color::Red, side);
     }
     
     bool isEmpty() const
@@ -239,6 +248,7 @@ public:
     }
 
 private:
+    MemoryPool<Arc<T>>* mArcPool;
     Arc<T>* mNil;
     Arc<T>* mRoot;
 
@@ -474,7 +484,7 @@ private:
         {
             free(x->left);
             free(x->right);
-            delete x;
+            mArcPool->destroy(x);
         }
     }
 
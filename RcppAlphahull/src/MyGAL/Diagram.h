@@ -19,9 +19,9 @@
 
 // STL
 #include <vector>
-#include <list>
 #include <unordered_set>
 // My includes
+#include "Arena.h"
 #include "Box.h"
 #include "Triangulation.h"
 
@@ -62,10 +62,11 @@ public:
     struct Vertex
     {
         Vector2<T> point; /**< Coordinates of the vertex */
+        bool onFrontier = false; /**< True if the vertex was created on the frontier of the box (bounding, corners or intersection) */
 
     private:
         friend Diagram<T>;
-        typename std::list<Vertex>::iterator it;
+        std::size_t index; /**< Index of the vertex in mVertices */
     };
 
     /**
@@ -82,7 +83,21 @@ public:
 
     private:
         friend Diagram;
-        typename std::list<HalfEdge>::iterator it;
+        std::size_t index; /**< Index of the half-edge in mHalfEdges */
+        std::size_t edge = NoEdge; /**< Index of the edge in mEdges, NoEdge for the half-edges added by the bounding */
+    };
+
+    /**
+     * \brief Edge of the diagram, made of two twin half-edges
+     *
+     * The half-edges added on the frontier of the box by the bounding have no
+     * twin and are not edges. If the diagram is intersected with a box, a
+     * half-edge that is removed is replaced by nullptr.
+     */
+    struct Edge
+    {
+        HalfEdge* leftHalfEdge; /**< Half-edge of the face on the left of the breakpoint that traced the edge */
+        HalfEdge* rightHalfEdge; /**< Half-edge of the face on the right of the breakpoint, twin of leftHalfEdge */
     };
 
     /**
@@ -173,9 +188,9 @@ public:
     /**
      * \brief Get vertices
      *
-     * \return Const reference to the list of vertices of the diagram
+     * \return Const reference to the vertices of the diagram, in order of creation
      */
-    const std::list<Vertex>& getVertices() const
+    const Arena<Vertex>& getVertices() const
     {
         return mVertices;
     }
@@ -183,13 +198,48 @@ public:
     /**
      * \brief Get half-edges
      *
-     * \return Const reference to the list of half-edges of the diagram
+     * \return Const reference to the half-edges of the diagram, in order of creation
      */
-    const std::list<HalfEdge>& getHalfEdges() const
+    const Arena<HalfEdge>& getHalfEdges() const
     {
         return mHalfEdges;
     }
 
+    /**
+     * \brief Get edges
+     *
+     * The i-th edge is the i-th pair of twin half-edges created during the
+     * construction, edges are never reordered.
+     *
+     * \return Const reference to the vector of edges of the diagram, in order of creation
+     */
+    const std::vector<Edge>& getEdges() const
+    {
+        return mEdges;
+    }
+
+    /**
+     * \brief Get an edge
+     *
+     * \param i Index of the requested edge
+     *
+     * \return Const reference to the requested edge
+     */
+    const Edge& getEdge(std::size_t i) const
+    {
+        return mEdges[i];
+    }
+
+    /**
+     * \brief Get the number of edges
+     *
+     * \return The number of edges
+     */
+    std::size_t getNbEdges() const
+    {
+        return mEdges.size();
+    }
+
     // Intersection with a box
 
     /**
@@ -239,8 +289,8 @@ public:
                         }
                         else
                         {
-                            halfEdge->origin = createVertex(intersections[0].point);
-                            halfEdge->destination = createVertex(intersections[1].point);
+                            halfEdge->origin = createFrontierVertex(intersections[0].point);
+                            halfEdge->destination = createFrontierVertex(intersections[1].point);
                         }
                         if (outgoingHalfEdge != nullptr)
                             link(box, outgoingHalfEdge, outgoingSide, halfEdge, intersections[0].side);
@@ -265,7 +315,7 @@ public:
                         if (processedHalfEdges.find(halfEdge->twin) != processedHalfEdges.end())
                             halfEdge->destination = halfEdge->twin->origin;
                         else
-                            halfEdge->destination = createVertex(intersections[0].point);
+                            halfEdge->destination = createFrontierVertex(intersections[0].point);
                         outgoingHalfEdge = halfEdge;
                         outgoingSide = intersections[0].side;
                         processedHalfEdges.emplace(halfEdge);
@@ -283,7 +333,7 @@ public:
                         if (processedHalfEdges.find(halfEdge->twin) != processedHalfEdges.end())
                             halfEdge->origin = halfEdge->twin->destination;
                         else
-                            halfEdge->origin = createVertex(intersections[0].point);
+                            halfEdge->origin = createFrontierVertex(intersections[0].point);
                         if (outgoingHalfEdge != nullptr)
                             link(box, outgoingHalfEdge, outgoingSide, halfEdge, intersections[0].side);
                         if (incomingHalfEdge == nullptr)
@@ -386,10 +436,13 @@ public:
     }
 
 private:
+    static constexpr std::size_t NoEdge = static_cast<std::size_t>(-1);
+
     std::vector<Site> mSites; /**< Sites of the diagram */
     std::vector<Face> mFaces; /**< Faces of the diagram */
-    std::list<Vertex> mVertices; /**< Vertices of the diagram */
-    std::list<HalfEdge> mHalfEdges; /**< Half-edges of the diagram */
+    Arena<Vertex> mVertices; /**< Vertices of the diagram */
+    Arena<HalfEdge> mHalfEdges; /**< Half-edges of the diagram */
+    std::vector<Edge> mEdges; /**< Pairs of twin half-edges of the diagram */
 
     // Diagram construction
 
@@ -400,6 +453,11 @@ private:
     {
         mSites.reserve(points.size());
         mFaces.reserve(points.size());
+        // A Voronoi diagram of n sites has at most 2n - 5 vertices and 3n - 6 edges
+        // (so 6n - 12 half-edges), bounding adds a few more on the frontier
+        mVertices.reserve(2 * points.size());
+        mHalfEdges.reserve(6 * points.size());
+        mEdges.reserve(3 * points.size());
         for (auto i = std::size_t(0); i < points.size(); ++i)
         {
             mSites.push_back(Diagram::Site{i, points[i], nullptr});
@@ -418,12 +476,19 @@ private:
         return &mFaces[i];
     }
 
-    Vertex* createVertex(Vector2<T> point)
+    Vertex* createVertex(Vector2<T> point, bool onFrontier = false)
     {
-        mVertices.emplace_back();
-        mVertices.back().point = point;
-        mVertices.back().it = std::prev(mVertices.end());
-        return &mVertices.back();
+        auto i = mVertices.create();
+        auto vertex = &mVertices[i];
+        vertex->point = point;
+        vertex->onFrontier = onFrontier;
+        vertex->index = i;
+        return vertex;
+    }
+
+    Vertex* createFrontierVertex(Vector2<T> point)
+    {
+        return createVertex(point, true);
     }
 
     Vertex* createCorner(Box<T> box, typename Box<T>::Side side)
@@ -431,13 +496,13 @@ private:
         switch (side)
         {
             case Box<T>::Side::Left:
-                return createVertex(Vector2<T>(box.left, box.top));
+                return createFrontierVertex(Vector2<T>(box.left, box.top));
             case Box<T>::Side::Bottom:
-                return createVertex(Vector2<T>(box.left, box.bottom));
+                return createFrontierVertex(Vector2<T>(box.left, box.bottom));
             case Box<T>::Side::Right:
-                return createVertex(Vector2<T>(box.right, box.bottom));
+                return createFrontierVertex(Vector2<T>(box.right, box.bottom));
             case Box<T>::Side::Top:
-                return createVertex(Vector2<T>(box.right, box.top));
+                return createFrontierVertex(Vector2<T>(box.right, box.top));
             default:
                 return nullptr;
         }
@@ -445,12 +510,25 @@ private:
 
     HalfEdge* createHalfEdge(Face* face)
     {
-        mHalfEdges.emplace_back();
-        mHalfEdges.back().incidentFace = face;
-        mHalfEdges.back().it = std::prev(mHalfEdges.end());
+        auto i = mHalfEdges.create();
+        auto halfEdge = &mHalfEdges[i];
+        halfEdge->incidentFace = face;
+        halfEdge->index = i;
         if (face->outerComponent == nullptr)
-            face->outerComponent = &mHalfEdges.back();
-        return &mHalfEdges.back();
+            face->outerComponent = halfEdge;
+        return halfEdge;
+    }
+
+    Edge& createEdge(Face* left, Face* right)
+    {
+        auto leftHalfEdge = createHalfEdge(left);
+        auto rightHalfEdge = createHalfEdge(right);
+        leftHalfEdge->twin = rightHalfEdge;
+        rightHalfEdge->twin = leftHalfEdge;
+        leftHalfEdge->edge = mEdges.size();
+        rightHalfEdge->edge = mEdges.size();
+        mEdges.push_back(Edge{leftHalfEdge, rightHalfEdge});
+        return mEdges.back();
     }
 
     // Intersection with a box
@@ -478,12 +556,17 @@ private:
 
     void removeVertex(Vertex* vertex)
     {
-        mVertices.erase(vertex->it);
+        mVertices.erase(vertex->index);
     }
 
     void removeHalfEdge(HalfEdge* halfEdge)
     {
-        mHalfEdges.erase(halfEdge->it);
+        if (halfEdge->edge != NoEdge)
+        {
+            auto& edge = mEdges[halfEdge->edge];
+            (edge.leftHalfEdge == halfEdge ? edge.leftHalfEdge : edge.rightHalfEdge) = nullptr;
+        }
+        mHalfEdges.erase(halfEdge->index);
     }
 };
 
@@ -0,0 +1,179 @@
+/* MyGAL
+ * Copyright (C) 2019 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// STL
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+// My includes
+#include "Event.h"
+
+/**
+ * \brief Namespace of MyGAL
+ */
+namespace mygal
+{
+
+/**
+ * \brief Priority queue of the events of Fortune's algorithm
+ *
+ * The queue is a d-ary max-heap, the event with the highest y (then the
+ * highest x) is on top. The keys are copied in the nodes of the heap so
+ * that sifting only reads contiguous memory, the events themselves are
+ * not owned by the queue and only see their `index` updated when they move.
+ *
+ * \tparam T Floating point type of the events
+ * \tparam Arity Number of children of each node
+ */
+template<typename T, std::size_t Arity = 4>
+class EventQueue
+{
+    static_assert(Arity >= 2, "Arity must be at least 2");
+
+public:
+    // Accessors
+
+    bool isEmpty() const
+    {
+        return mNodes.empty();
+    }
+
+    std::size_t getSize() const
+    {
+        return mNodes.size();
+    }
+
+    /**
+     * \brief Get the next event without removing it, the queue must not be empty
+     */
+    Event<T>* top() const
+    {
+        return mNodes.front().event;
+    }
+
+    // Operations
+
+    void reserve(std::size_t n)
+    {
+        mNodes.reserve(n);
+    }
+
+    Event<T>* pop()
+    {
+        auto event = mNodes.front().event;
+        remove(0);
+        return event;
+    }
+
+    void push(Event<T>* event)
+    {
+        mNodes.push_back(Node{event->y, event->x, event});
+        siftUp(mNodes.size() - 1);
+    }
+
+    /**
+     * \brief Remove the event at the given position in the heap
+     *
+     * \param i Current `index` of the event
+     */
+    void remove(std::size_t i)
+    {
+        auto last = mNodes.back();
+        mNodes.pop_back();
+        if (i < mNodes.size())
+        {
+            mNodes[i] = last;
+            if (i > 0 && isBefore(mNodes[i], mNodes[getParent(i)]))
+                siftUp(i);
+            else
+                siftDown(i);
+        }
+    }
+
+private:
+    struct Node
+    {
+        T y;
+        T x;
+        Event<T>* event;
+    };
+
+    std::vector<Node> mNodes;
+
+    // Same order as operator< on events: the greatest event has the highest priority
+    static bool isBefore(const Node& lhs, const Node& rhs)
+    {
+        return rhs.y < lhs.y || (rhs.y == lhs.y && rhs.x < lhs.x);
+    }
+
+    static std::size_t getParent(std::size_t i)
+    {
+        return (i - 1) / Arity;
+    }
+
+    static std::size_t getFirstChild(std::size_t i)
+    {
+        return Arity * i + 1;
+    }
+
+    void place(std::size_t i, const Node& node)
+    {
+        mNodes[i] = node;
+        node.event->index = static_cast<int>(i);
+    }
+
+    void siftUp(std::size_t i)
+    {
+        auto node = mNodes[i];
+        while (i > 0)
+        {
+            auto parent = getParent(i);
+            if (!isBefore(node, mNodes[parent]))
+                break;
+            place(i, mNodes[parent]);
+            i = parent;
+        }
+        place(i, node);
+    }
+
+    void siftDown(std::size_t i)
+    {
+        auto node = mNodes[i];
+        while (true)
+        {
+            auto first = getFirstChild(i);
+            if (first >= mNodes.size())
+                break;
+            auto last = std::min(first + Arity, mNodes.size());
+            auto best = first;
+            for (auto child = first + 1; child < last; ++child)
+            {
+                if (isBefore(mNodes[child], mNodes[best]))
+                    best = child;
+            }
+            if (!isBefore(mNodes[best], node))
+                break;
+            place(i, mNodes[best]);
+            i = best;
+        }
+        place(i, node);
+    }
+};
+
+}
@@ -18,12 +18,16 @@
 #pragma once
 
 // STL
+#include <algorithm>
+#include <list>
 #include <unordered_map>
 // My includes
-#include "PriorityQueue.h"
+#include "MemoryPool.h"
+#include "EventQueue.h"
 #include "Diagram.h"
 #include "Beachline.h"
 #include "Event.h"
+#include "Predicates.h"
 #include "util.h"
 
 /**
@@ -43,6 +47,19 @@ template<typename T>
 class FortuneAlgorithm
 {
 public:
+    /**
+     * \brief Event of the sweep during which an edge of the diagram is created
+     *
+     * Each event, except the first site event, creates exactly one edge of the
+     * diagram, so the i-th element of the log corresponds to the i-th edge.
+     */
+    struct EdgeEvent
+    {
+        T y; /**< Ordinate of the sweep line */
+        T x; /**< Abscissa of the site or of the convergence point */
+        bool site; /**< True for a site event, false for a circle event */
+    };
+
     /**
      * \brief Constructor of FortuneAlgorithm
      *
@@ -50,32 +67,70 @@ public:
      *
      * \param points Coordinates of the sites that will be used to generate the Voronoi diagram
      */
-    explicit FortuneAlgorithm(std::vector<Vector2<T>> points) : mDiagram(std::move(points))
+    explicit FortuneAlgorithm(std::vector<Vector2<T>> points) : mDiagram(std::move(points)), mBeachline(mArcPool)
     {
 
     }
 
+    // Remove copy and move operations: the beachline allocates its arcs from mArcPool
+
+    FortuneAlgorithm(const FortuneAlgorithm&) = delete;
+    FortuneAlgorithm& operator=(const FortuneAlgorithm&) = delete;
+    FortuneAlgorithm(FortuneAlgorithm&&) = delete;
+    FortuneAlgorithm& operator=(FortuneAlgorithm&&) = delete;
+
+    /**
+     * \brief Record the events that create the edges during FortuneAlgorithm::construct
+     *
+     * \param log Vector to which the events are appended, nullptr to disable the recording
+     */
+    void setEdgeEventLog(std::vector<EdgeEvent>* log)
+    {
+        mEdgeEvents = log;
+    }
+
     /**
      * \brief Execute Fortune's algorithm to construct the diagram
      *
      * At the end of this method, the diagram is unbounded. The method 
      * FortuneAlgorithm::bound shoud be called to bound the diagram.
+     *
+     * The sites are sorted once and read in order, only the circle events
+     * go through the event queue.
      */
     void construct()
     {
-        // Initialize event queue
+        // Sort the sites in the order in which the sweep line meets them
+        auto sites = std::vector<typename Diagram<T>::Site*>();
+        sites.reserve(mDiagram.getNbSites());
         for (auto i = std::size_t(0); i < mDiagram.getNbSites(); ++i)
-            mEvents.push(std::make_unique<Event<T>>(mDiagram.getSite(i)));
+            sites.push_back(mDiagram.getSite(i));
+        std::sort(sites.begin(), sites.end(), [](const typename Diagram<T>::Site* lhs, const typename Diagram<T>::Site* rhs)
+        {
+            return rhs->point.y < lhs->point.y || (rhs->point.y == lhs->point.y && rhs->point.x < lhs->point.x);
+        });
 
-        // Process events
-        while (!mEvents.isEmpty())
+        // Process events, merging the sorted sites with the circle events
+        auto nextSite = sites.cbegin();
+        while (nextSite != sites.cend() || !mEvents.isEmpty())
         {
-            auto event = mEvents.pop();
-            mBeachlineY = event->y;
-            if (event->type == Event<T>::Type::Site)
-                handleSiteEvent(event.get());
+            if (nextSite != sites.cend() && (mEvents.isEmpty() || !isBefore(mEvents.top(), *nextSite)))
+            {
+                auto site = *nextSite++;
+                mBeachlineY = site->point.y;
+                if (mEdgeEvents != nullptr && !mBeachline.isEmpty())
+                    mEdgeEvents->push_back(EdgeEvent{site->point.y, site->point.x, true});
+                handleSiteEvent(site);
+            }
             else
-                handleCircleEvent(event.get());
+            {
+                auto event = mEvents.pop();
+                mBeachlineY = event->y;
+                if (mEdgeEvents != nullptr)
+                    mEdgeEvents->push_back(EdgeEvent{event->y, event->x, false});
+                handleCircleEvent(event);
+                mEventPool.destroy(event);
+            }
         }
     }
 
@@ -94,7 +149,6 @@ public:
      */
     bool bound(Box<T> box)
     {
-        auto success = true;
         // 1. Make sure the bounding box contains all the vertices
         for (const auto& vertex : mDiagram.getVertices()) // Much faster when using vector<unique_ptr<Vertex*>, maybe we can only test vertices in border cells to speed up
         {
@@ -103,26 +157,8 @@ public:
             box.right = std::max(vertex.point.x, box.right);
             box.top = std::max(vertex.point.y, box.top);
         }
-        // 2. Retrieve all non bounded half edges from the beach line
-        auto linkedVertices = std::list<LinkedVertex>();
-        auto vertices = VerticeOnFrontierContainer(mDiagram.getNbSites());
-        if (!mBeachline.isEmpty())
-        {
-            auto arc = mBeachline.getLeftmostArc();
-            while (!mBeachline.isNil(arc->next))
-            {
-                success = boundEdge(box, arc, arc->next, linkedVertices, vertices) && success;
-                arc = arc->next;
-            }
-        }
-        // 3. Add corners if necessary
-        for (auto& kv : vertices)
-            success = addCorners(box, linkedVertices, kv.second) && success;
-        // 4. Join the half-edges
-        for (auto& kv : vertices)
-            joinHalfEdges(kv.first, kv.second);
-        // Return the status
-        return success;
+        // 2. Bound the edges with the box
+        return boundWith(box);
     }
     
     /*_____________________________________________________*/
@@ -148,7 +184,6 @@ public:
      */
     bool bound(Box<T>* box, const T& dist)
     {
-        auto success = true;
         // 1. Make sure the bounding box contains all the vertices
         for (const auto& vertex : mDiagram.getVertices()) // Much faster when using vector<unique_ptr<Vertex*>, maybe we can only test vertices in border cells to speed up
         {
@@ -163,6 +198,26 @@ public:
         box->right  = box->right + dist;
         box->top    = box->top + dist;
         
+        // 2. Bound the edges with the box
+        return boundWith(*box);
+    }
+
+    /**
+     * \brief Bound the Voronoi diagram with exactly the given box
+     *
+     * The method FortuneAlgorithm::construct must be called before this one to construct the diagram.
+     *
+     * Contrary to FortuneAlgorithm::bound, the box is not enlarged to contain the vertices of the
+     * diagram: the caller is responsible for it. The infinite edges are clipped where they leave
+     * the box, so two diagrams bounded with the same box have the same vertices on the frontier.
+     *
+     * \param box Box to use for bounding
+     *
+     * \return True if no error occurs during intersection, false otherwise
+     */
+    bool boundWith(const Box<T>& box)
+    {
+        auto success = true;
         // 2. Retrieve all non bounded half edges from the beach line
         auto linkedVertices = std::list<LinkedVertex>();
         auto vertices = VerticeOnFrontierContainer(mDiagram.getNbSites());
@@ -171,13 +226,13 @@ public:
             auto arc = mBeachline.getLeftmostArc();
             while (!mBeachline.isNil(arc->next))
             {
-                success = boundEdge(*box, arc, arc->next, linkedVertices, vertices) && success;
+                success = boundEdge(box, arc, arc->next, linkedVertices, vertices) && success;
                 arc = arc->next;
             }
         }
         // 3. Add corners if necessary
         for (auto& kv : vertices)
-            success = addCorners(*box, linkedVertices, kv.second) && success;
+            success = addCorners(box, linkedVertices, kv.second) && success;
         // 4. Join the half-edges
         for (auto& kv : vertices)
             joinHalfEdges(kv.first, kv.second);
@@ -197,17 +252,30 @@ public:
         return std::move(mDiagram);
     }
 
+    /**
+     * \brief Get the diagram under construction without moving it
+     *
+     * \return Const reference to the diagram constructed by the class
+     */
+    const Diagram<T>& viewDiagram() const
+    {
+        return mDiagram;
+    }
+
 private:
     Diagram<T> mDiagram;
+    // The pools must be declared before the structures using them
+    MemoryPool<Arc<T>> mArcPool;
+    MemoryPool<Event<T>> mEventPool;
     Beachline<T> mBeachline;
-    PriorityQueue<Event<T>> mEvents;
+    EventQueue<T> mEvents;
     T mBeachlineY;
+    std::vector<EdgeEvent>* mEdgeEvents = nullptr;
 
     // Algorithm
 
-    void handleSiteEvent(Event<T>* event)
+    void handleSiteEvent(typename Diagram<T>::Site* site)
     {
-        auto site = event->site;
         // 1. Check if the beachline is empty
         if (mBeachline.isEmpty())
         {
@@ -234,6 +302,12 @@ private:
             addEvent(middleArc, rightArc, rightArc->next);
     }
 
+    // Return true if the circle event must be processed before the site event
+    bool isBefore(const Event<T>* event, const typename Diagram<T>::Site* site) const
+    {
+        return site->point.y < event->y || (site->point.y == event->y && site->point.x < event->x);
+    }
+
     void handleCircleEvent(Event<T>* event)
     {
         auto point = event->point;
@@ -271,7 +345,7 @@ private:
         mBeachline.insertBefore(middleArc, leftArc);
         mBeachline.insertAfter(middleArc, rightArc);
         // Delete old arc
-        delete arc;
+        mArcPool.destroy(arc);
         // Return the middle arc
         return middleArc;
     }
@@ -294,31 +368,19 @@ private:
         setPrevHalfEdge(arc->prev->rightHalfEdge, prevHalfEdge);
         setPrevHalfEdge(nextHalfEdge, arc->next->leftHalfEdge);
         // Delete node
-        delete arc;
+        mArcPool.destroy(arc);
     }
 
     // Breakpoints
     
-    bool isMovingRight(const Arc<T>* left, const Arc<T>* right) const
-    {
-        return left->site->point.y < right->site->point.y;
-    }
-
-    T getInitialX(const Arc<T>* left, const Arc<T>* right, bool movingRight) const
-    {
-        return movingRight ? left->site->point.x : right->site->point.x;
-    }
-
     // Edges
 
     void addEdge(Arc<T>* left, Arc<T>* right)
     {
-        // Create two new half edges
-        left->rightHalfEdge = mDiagram.createHalfEdge(left->site->face);
-        right->leftHalfEdge = mDiagram.createHalfEdge(right->site->face);
-        // Set the two half edges twins
-        left->rightHalfEdge->twin = right->leftHalfEdge;
-        right->leftHalfEdge->twin = left->rightHalfEdge;
+        // Create a new edge made of two twin half edges
+        auto& edge = mDiagram.createEdge(left->site->face, right->site->face);
+        left->rightHalfEdge = edge.leftHalfEdge;
+        right->leftHalfEdge = edge.rightHalfEdge;
     }
 
     void setOrigin(Arc<T>* left, Arc<T>* right, typename Diagram<T>::Vertex* vertex)
@@ -345,26 +407,16 @@ private:
     {
         auto y = T();
         auto convergencePoint = computeConvergencePoint(left->site->point, middle->site->point, right->site->point, y);
-        // Check that the bottom of the circle is below the beachline
-        if (!almostLower(y, mBeachlineY))
+        // Check that the breakpoints converge
+        if (y == std::numeric_limits<T>::infinity())
             return;
-        // Check that the event is valid by checking that the middle arc will indeed shrink
-        // To do that we check in which direction the breakpoint are moving and that the
-        // convergence point is somewhere the breakpoints are moving to
-        auto leftBreakpointMovingRight = isMovingRight(left, middle);
-        auto rightBreakpointMovingRight = isMovingRight(middle, right);
-        auto leftInitialX = getInitialX(left, middle, leftBreakpointMovingRight);
-        auto rightInitialX = getInitialX(middle, right, rightBreakpointMovingRight);
-        if (!(!leftBreakpointMovingRight && rightBreakpointMovingRight) &&
-            ((leftBreakpointMovingRight && almostLower(leftInitialX, convergencePoint.x)) ||
-            (!leftBreakpointMovingRight && almostGreater(leftInitialX, convergencePoint.x))) &&
-            ((rightBreakpointMovingRight && almostLower(rightInitialX, convergencePoint.x)) ||
-            (!rightBreakpointMovingRight && almostGreater(rightInitialX, convergencePoint.x))))
-        {
-            auto event = std::make_unique<Event<T>>(y, convergencePoint, middle);
-            middle->event = event.get();
-            mEvents.push(std::move(event));
-        }
+        // The bottom of the circle of converging arcs is below the beachline, it can only be above it
+        // because of rounding errors (e.g. a site that falls on a breakpoint creates an event at its own
+        // position)
+        y = std::min(y, mBeachlineY);
+        auto event = mEventPool.create(y, convergencePoint, middle);
+        middle->event = event;
+        mEvents.push(event);
     }
 
     void deleteEvent(Arc<T>* arc)
@@ -372,24 +424,26 @@ private:
         if (arc->event != nullptr)
         {
             mEvents.remove(arc->event->index);
+            mEventPool.destroy(arc->event);
             arc->event = nullptr;
         }
     }
 
     Vector2<T> computeConvergencePoint(const Vector2<T>& point1, const Vector2<T>& point2, const Vector2<T>& point3, T& y) const
     {
+        // The breakpoints of the middle arc converge if and only if the sites turn clockwise (exact test),
+        // otherwise or if the points are aligned there is no solution
         auto v1 = (point1 - point2).getOrthogonal();
         auto v2 = (point2 - point3).getOrthogonal();
-        auto delta = static_cast<T>(0.5) * (point3 - point1);
         auto denom = v1.getDet(v2);
-        // If there is no solution (points are aligned)
-        if (almostZero(denom))
+        if (orientation(point1, point2, point3) >= 0 || denom == 0)
         {
             // Infinity means that the event will never be added to the event queue
             y = std::numeric_limits<T>::infinity();
             return Vector2<T>();
         }
         // Otherwise, there is a solution
+        auto delta = static_cast<T>(0.5) * (point3 - point1);
         auto t = delta.getDet(v2) / denom;
         auto center = static_cast<T>(0.5) * (point1 + point2) + t * v1;
         auto r = center.getDistance(point1);
@@ -418,7 +472,7 @@ private:
         // Line-box intersection
         auto intersection = box.getFirstIntersection(origin, direction);
         // Create a new vertex and ends the half edges
-        auto vertex = mDiagram.createVertex(intersection.point);
+        auto vertex = mDiagram.createFrontierVertex(intersection.point);
         setDestination(leftArc, rightArc, vertex);
         // Initialize pointers
         if (vertices.find(leftArc->site->index) == vertices.end()) 
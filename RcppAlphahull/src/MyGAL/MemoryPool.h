@@ -0,0 +1,132 @@
+/* MyGAL
+ * Copyright (C) 2019 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// STL
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * \brief Namespace of MyGAL
+ */
+namespace mygal
+{
+
+/**
+ * \brief Pool of objects of the same type
+ *
+ * Objects are allocated in slabs of `ChunkSize` slots. A destroyed object
+ * puts its slot in a free list so that the next creation reuses it
+ * without allocating. The slabs are released with the pool.
+ *
+ * Objects still alive when the pool is destroyed are not destroyed, thus
+ * `T` must be trivially destructible.
+ *
+ * \tparam T Type of the objects
+ * \tparam ChunkSize Number of slots per slab
+ */
+template<typename T, std::size_t ChunkSize = 1024>
+class MemoryPool
+{
+    static_assert(std::is_trivially_destructible<T>::value, "T must be trivially destructible");
+
+public:
+    MemoryPool() = default;
+
+    // Remove copy operations
+
+    MemoryPool(const MemoryPool&) = delete;
+    MemoryPool& operator=(const MemoryPool&) = delete;
+
+    // Move operations
+
+    MemoryPool(MemoryPool&& other) : mChunks(std::move(other.mChunks)),
+        mFreeSlots(std::exchange(other.mFreeSlots, nullptr)), mNbUsedSlots(std::exchange(other.mNbUsedSlots, ChunkSize))
+    {
+
+    }
+
+    MemoryPool& operator=(MemoryPool&& other)
+    {
+        mChunks = std::move(other.mChunks);
+        mFreeSlots = std::exchange(other.mFreeSlots, nullptr);
+        mNbUsedSlots = std::exchange(other.mNbUsedSlots, ChunkSize);
+        return *this;
+    }
+
+    // Operations
+
+    /**
+     * \brief Construct an object in the pool
+     *
+     * \param args Arguments forwarded to the constructor (or aggregate initialization) of `T`
+     *
+     * \return Pointer to the new object
+     */
+    template<typename... Args>
+    T* create(Args&&... args)
+    {
+        return new (allocate()) T{std::forward<Args>(args)...};
+    }
+
+    /**
+     * \brief Give back the slot of an object created by this pool
+     */
+    void destroy(T* object)
+    {
+        object->~T();
+        auto slot = reinterpret_cast<Slot*>(object);
+        slot->next = mFreeSlots;
+        mFreeSlots = slot;
+    }
+
+private:
+    union Slot
+    {
+        Slot* next;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+    };
+
+    std::vector<std::unique_ptr<Slot[]>> mChunks;
+    Slot* mFreeSlots = nullptr; /**< Head of the list of slots of destroyed objects */
+    std::size_t mNbUsedSlots = ChunkSize; /**< Number of slots already handed out in the last chunk */
+
+    void* allocate()
+    {
+        // Reuse the slot of a destroyed object first
+        if (mFreeSlots != nullptr)
+        {
+            auto slot = mFreeSlots;
+            mFreeSlots = slot->next;
+            return slot;
+        }
+        // Otherwise take the next slot of the last chunk
+        if (mNbUsedSlots == ChunkSize)
+        {
+            mChunks.emplace_back(new Slot[ChunkSize]);
+            mNbUsedSlots = 0;
+        }
+        return &mChunks.back()[mNbUsedSlots++];
+    }
+};
+
+}
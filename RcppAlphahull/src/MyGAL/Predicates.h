@@ -0,0 +1,304 @@
+/* MyGAL
+ * Copyright (C) 2019 Pierre Vigier
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// STL
+#include <cmath>
+#include <limits>
+#include <vector>
+// My includes
+#include "Vector2.h"
+
+/**
+ * \brief Namespace of MyGAL
+ */
+namespace mygal
+{
+
+/**
+ * \brief Exact arithmetic on floating point expansions
+ *
+ * An expansion is a sum of floating point numbers that do not overlap,
+ * stored by increasing magnitude, whose sign is the sign of its last
+ * component. The algorithms are the ones of J. R. Shewchuk, "Adaptive
+ * Precision Floating-Point Arithmetic and Fast Robust Geometric Predicates"
+ * (1997); they are exact as long as there is no overflow nor underflow and
+ * the arithmetic of T rounds to nearest without extended intermediates
+ * (true for double with SSE2 and for long double on x86-64).
+ */
+namespace expansion
+{
+
+template<typename T>
+struct Constants
+{
+    static constexpr T epsilon = std::numeric_limits<T>::epsilon() / 2; /**< Relative error of a rounding */
+    static T splitter() /**< 2^ceil(p/2) + 1, p number of bits of the mantissa */
+    {
+        return std::ldexp(static_cast<T>(1), (std::numeric_limits<T>::digits + 1) / 2) + 1;
+    }
+    static constexpr T orientationBound = (3 + 16 * epsilon) * epsilon;
+    static constexpr T inCircleBound = (10 + 96 * epsilon) * epsilon;
+};
+
+template<typename T>
+constexpr T Constants<T>::epsilon;
+template<typename T>
+constexpr T Constants<T>::orientationBound;
+template<typename T>
+constexpr T Constants<T>::inCircleBound;
+
+/**
+ * \brief x + y = a + b exactly, with x = fl(a + b), requires |a| >= |b|
+ */
+template<typename T>
+inline void fastTwoSum(T a, T b, T& x, T& y)
+{
+    x = a + b;
+    y = b - (x - a);
+}
+
+/**
+ * \brief x + y = a + b exactly, with x = fl(a + b)
+ */
+template<typename T>
+inline void twoSum(T a, T b, T& x, T& y)
+{
+    x = a + b;
+    auto bVirtual = x - a;
+    auto aVirtual = x - bVirtual;
+    y = (a - aVirtual) + (b - bVirtual);
+}
+
+/**
+ * \brief hi + lo = a exactly, both halves have at most half of the bits of the mantissa
+ */
+template<typename T>
+inline void split(T a, T& hi, T& lo)
+{
+    auto c = Constants<T>::splitter() * a;
+    hi = c - (c - a);
+    lo = a - hi;
+}
+
+/**
+ * \brief x + y = a * b exactly, with x = fl(a * b)
+ */
+template<typename T>
+inline void twoProduct(T a, T b, T& x, T& y)
+{
+    x = a * b;
+    T aHi, aLo, bHi, bLo;
+    split(a, aHi, aLo);
+    split(b, bHi, bLo);
+    auto error = ((x - aHi * bHi) - aLo * bHi) - aHi * bLo;
+    y = aLo * bLo - error;
+}
+
+/**
+ * \brief Adds a number to an expansion, zero components are removed
+ */
+template<typename T>
+std::vector<T> grow(const std::vector<T>& e, T b)
+{
+    std::vector<T> h;
+    h.reserve(e.size() + 1);
+    auto q = b;
+    for (auto component : e)
+    {
+        T sum, error;
+        twoSum(q, component, sum, error);
+        q = sum;
+        if (error != 0)
+            h.push_back(error);
+    }
+    if (q != 0 || h.empty())
+        h.push_back(q);
+    return h;
+}
+
+/**
+ * \brief Sum of two expansions
+ */
+template<typename T>
+std::vector<T> sum(std::vector<T> e, const std::vector<T>& f)
+{
+    for (auto component : f)
+        e = grow(e, component);
+    return e;
+}
+
+/**
+ * \brief Multiplies an expansion by a number, zero components are removed
+ */
+template<typename T>
+std::vector<T> scale(const std::vector<T>& e, T b)
+{
+    std::vector<T> h;
+    h.reserve(2 * e.size());
+    T q, error;
+    twoProduct(e[0], b, q, error);
+    if (error != 0)
+        h.push_back(error);
+    for (auto i = std::size_t(1); i < e.size(); ++i)
+    {
+        T product, productError, partial;
+        twoProduct(e[i], b, product, productError);
+        twoSum(q, productError, partial, error);
+        if (error != 0)
+            h.push_back(error);
+        fastTwoSum(product, partial, q, error);
+        if (error != 0)
+            h.push_back(error);
+    }
+    if (q != 0 || h.empty())
+        h.push_back(q);
+    return h;
+}
+
+/**
+ * \brief Product of two expansions
+ */
+template<typename T>
+std::vector<T> multiply(const std::vector<T>& e, const std::vector<T>& f)
+{
+    auto h = std::vector<T>{0};
+    for (auto component : f)
+        h = sum(h, scale(e, component));
+    return h;
+}
+
+/**
+ * \brief Expansion equal to a * b
+ */
+template<typename T>
+std::vector<T> product(T a, T b)
+{
+    T x, y;
+    twoProduct(a, b, x, y);
+    return y != 0 ? std::vector<T>{y, x} : std::vector<T>{x};
+}
+
+template<typename T>
+int sign(const std::vector<T>& e)
+{
+    return (e.back() > 0) - (e.back() < 0);
+}
+
+/**
+ * \brief Exact value of det([ax ay 1], [bx by 1], [cx cy 1])
+ */
+template<typename T>
+std::vector<T> orientation(const Vector2<T>& a, const Vector2<T>& b, const Vector2<T>& c)
+{
+    auto det = product(a.x, b.y);
+    det = sum(det, product(-a.y, b.x));
+    det = sum(det, product(b.x, c.y));
+    det = sum(det, product(-b.y, c.x));
+    det = sum(det, product(c.x, a.y));
+    det = sum(det, product(-c.y, a.x));
+    return det;
+}
+
+/**
+ * \brief Exact value of x^2 + y^2
+ */
+template<typename T>
+std::vector<T> lift(const Vector2<T>& p)
+{
+    return sum(product(p.x, p.x), product(p.y, p.y));
+}
+
+template<typename T>
+std::vector<T> negate(std::vector<T> e)
+{
+    for (auto& component : e)
+        component = -component;
+    return e;
+}
+
+}
+
+/**
+ * \brief Orientation of three points
+ *
+ * The determinant is first evaluated in floating point and its sign is
+ * returned if it is larger than the bound on the rounding errors, otherwise
+ * it is computed exactly. Only nearly aligned points pay for the exact
+ * computation.
+ *
+ * \return 1 if a, b and c turn counterclockwise, -1 if they turn clockwise
+ * and 0 if they are aligned
+ */
+template<typename T>
+int orientation(const Vector2<T>& a, const Vector2<T>& b, const Vector2<T>& c)
+{
+    auto detLeft = (a.x - c.x) * (b.y - c.y);
+    auto detRight = (a.y - c.y) * (b.x - c.x);
+    auto det = detLeft - detRight;
+    auto detSum = std::fabs(detLeft) + std::fabs(detRight);
+    // If the two products have different signs there is no cancellation
+    if ((detLeft > 0 && detRight <= 0) || (detLeft < 0 && detRight >= 0) || detLeft == 0)
+        return (det > 0) - (det < 0);
+    auto bound = expansion::Constants<T>::orientationBound * detSum;
+    if (det >= bound || -det >= bound)
+        return (det > 0) - (det < 0);
+    return expansion::sign(expansion::orientation(a, b, c));
+}
+
+/**
+ * \brief Position of a point with respect to the circle through three points
+ *
+ * Same adaptive evaluation as orientation().
+ *
+ * \return 1 if d is inside the circle through a, b and c (given counterclockwise),
+ * -1 if it is outside and 0 if the four points are cocircular; the sign is
+ * reversed if a, b and c turn clockwise
+ */
+template<typename T>
+int inCircle(const Vector2<T>& a, const Vector2<T>& b, const Vector2<T>& c, const Vector2<T>& d)
+{
+    auto ad = a - d;
+    auto bd = b - d;
+    auto cd = c - d;
+    auto bdxcdy = bd.x * cd.y;
+    auto cdxbdy = cd.x * bd.y;
+    auto aLift = ad.x * ad.x + ad.y * ad.y;
+    auto cdxady = cd.x * ad.y;
+    auto adxcdy = ad.x * cd.y;
+    auto bLift = bd.x * bd.x + bd.y * bd.y;
+    auto adxbdy = ad.x * bd.y;
+    auto bdxady = bd.x * ad.y;
+    auto cLift = cd.x * cd.x + cd.y * cd.y;
+    auto det = aLift * (bdxcdy - cdxbdy) + bLift * (cdxady - adxcdy) + cLift * (adxbdy - bdxady);
+    auto permanent = (std::fabs(bdxcdy) + std::fabs(cdxbdy)) * aLift +
+        (std::fabs(cdxady) + std::fabs(adxcdy)) * bLift +
+        (std::fabs(adxbdy) + std::fabs(bdxady)) * cLift;
+    auto bound = expansion::Constants<T>::inCircleBound * permanent;
+    if (det > bound || -det > bound)
+        return (det > 0) - (det < 0);
+    // Exact evaluation of the 4x4 determinant with rows [x y x^2+y^2 1], expanded along the lifted column
+    namespace ex = expansion;
+    auto exact = ex::multiply(ex::lift(a), ex::orientation(b, c, d));
+    exact = ex::sum(exact, ex::negate(ex::multiply(ex::lift(b), ex::orientation(a, c, d))));
+    exact = ex::sum(exact, ex::multiply(ex::lift(c), ex::orientation(a, b, d)));
+    exact = ex::sum(exact, ex::negate(ex::multiply(ex::lift(d), ex::orientation(a, b, c))));
+    return ex::sign(exact);
+}
+
+}
@@ -5,73 +5,245 @@
 
 using namespace Rcpp;
 
+// computeAhullsRcpp
+Rcpp::List computeAhullsRcpp(const Rcpp::List& delvor_obj, const Rcpp::NumericVector& alpha, const int threads, const std::string precision);
+RcppExport SEXP _RcppAlphahull_computeAhullsRcpp(SEXP delvor_objSEXP, SEXP alphaSEXP, SEXP threadsSEXP, SEXP precisionSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const Rcpp::List& >::type delvor_obj(delvor_objSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::NumericVector& >::type alpha(alphaSEXP);
+    Rcpp::traits::input_parameter< const int >::type threads(threadsSEXP);
+    Rcpp::traits::input_parameter< const std::string >::type precision(precisionSEXP);
+    rcpp_result_gen = Rcpp::wrap(computeAhullsRcpp(delvor_obj, alpha, threads, precision));
+    return rcpp_result_gen;
+END_RCPP
+}
 // computeAhullRcpp
-Rcpp::List computeAhullRcpp(Rcpp::List ashape);
-RcppExport SEXP _RcppAlphahull_computeAhullRcpp(SEXP ashapeSEXP) {
+Rcpp::List computeAhullRcpp(Rcpp::List ashape, const int threads, const std::string precision);
+RcppExport SEXP _RcppAlphahull_computeAhullRcpp(SEXP ashapeSEXP, SEXP threadsSEXP, SEXP precisionSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Rcpp::List >::type ashape(ashapeSEXP);
+    Rcpp::traits::input_parameter< const int >::type threads(threadsSEXP);
+    Rcpp::traits::input_parameter< const std::string >::type precision(precisionSEXP);
+    rcpp_result_gen = Rcpp::wrap(computeAhullRcpp(ashape, threads, precision));
+    return rcpp_result_gen;
+END_RCPP
+}
+// computeAhullHandleRcpp
+Rcpp::List computeAhullHandleRcpp(Rcpp::List ashape, const int threads);
+RcppExport SEXP _RcppAlphahull_computeAhullHandleRcpp(SEXP ashapeSEXP, SEXP threadsSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< Rcpp::List >::type ashape(ashapeSEXP);
-    rcpp_result_gen = Rcpp::wrap(computeAhullRcpp(ashape));
+    Rcpp::traits::input_parameter< const int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(computeAhullHandleRcpp(ashape, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// computeAshapeHandleRcpp
+Rcpp::List computeAshapeHandleRcpp(SEXP handle, const long double& alpha);
+RcppExport SEXP _RcppAlphahull_computeAshapeHandleRcpp(SEXP handleSEXP, SEXP alphaSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type handle(handleSEXP);
+    Rcpp::traits::input_parameter< const long double& >::type alpha(alphaSEXP);
+    rcpp_result_gen = Rcpp::wrap(computeAshapeHandleRcpp(handle, alpha));
+    return rcpp_result_gen;
+END_RCPP
+}
+// computeAshapesHandleRcpp
+Rcpp::List computeAshapesHandleRcpp(SEXP handle, const Rcpp::NumericVector& alpha, const int threads);
+RcppExport SEXP _RcppAlphahull_computeAshapesHandleRcpp(SEXP handleSEXP, SEXP alphaSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type handle(handleSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::NumericVector& >::type alpha(alphaSEXP);
+    Rcpp::traits::input_parameter< const int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(computeAshapesHandleRcpp(handle, alpha, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// computeAshapesRcpp
+Rcpp::List computeAshapesRcpp(const Rcpp::List& delvor_obj, const Rcpp::NumericVector& alpha, const int threads, const std::string precision);
+RcppExport SEXP _RcppAlphahull_computeAshapesRcpp(SEXP delvor_objSEXP, SEXP alphaSEXP, SEXP threadsSEXP, SEXP precisionSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const Rcpp::List& >::type delvor_obj(delvor_objSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::NumericVector& >::type alpha(alphaSEXP);
+    Rcpp::traits::input_parameter< const int >::type threads(threadsSEXP);
+    Rcpp::traits::input_parameter< const std::string >::type precision(precisionSEXP);
+    rcpp_result_gen = Rcpp::wrap(computeAshapesRcpp(delvor_obj, alpha, threads, precision));
     return rcpp_result_gen;
 END_RCPP
 }
 // computeAshapeRcpp
-Rcpp::List computeAshapeRcpp(const Rcpp::List& delvor_obj, const long double& alpha);
-RcppExport SEXP _RcppAlphahull_computeAshapeRcpp(SEXP delvor_objSEXP, SEXP alphaSEXP) {
+Rcpp::List computeAshapeRcpp(const Rcpp::List& delvor_obj, const long double& alpha, const int threads, const std::string precision);
+RcppExport SEXP _RcppAlphahull_computeAshapeRcpp(SEXP delvor_objSEXP, SEXP alphaSEXP, SEXP threadsSEXP, SEXP precisionSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const Rcpp::List& >::type delvor_obj(delvor_objSEXP);
+    Rcpp::traits::input_parameter< const long double& >::type alpha(alphaSEXP);
+    Rcpp::traits::input_parameter< const int >::type threads(threadsSEXP);
+    Rcpp::traits::input_parameter< const std::string >::type precision(precisionSEXP);
+    rcpp_result_gen = Rcpp::wrap(computeAshapeRcpp(delvor_obj, alpha, threads, precision));
+    return rcpp_result_gen;
+END_RCPP
+}
+// computeAlphaSpectrumRcpp
+Rcpp::List computeAlphaSpectrumRcpp(const Rcpp::List& delvor_obj, const int threads, const std::string precision);
+RcppExport SEXP _RcppAlphahull_computeAlphaSpectrumRcpp(SEXP delvor_objSEXP, SEXP threadsSEXP, SEXP precisionSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< const Rcpp::List& >::type delvor_obj(delvor_objSEXP);
+    Rcpp::traits::input_parameter< const int >::type threads(threadsSEXP);
+    Rcpp::traits::input_parameter< const std::string >::type precision(precisionSEXP);
+    rcpp_result_gen = Rcpp::wrap(computeAlphaSpectrumRcpp(delvor_obj, threads, precision));
+    return rcpp_result_gen;
+END_RCPP
+}
+// ashapeFromSpectrumRcpp
+Rcpp::List ashapeFromSpectrumRcpp(const Rcpp::List& spectrum, const double alpha);
+RcppExport SEXP _RcppAlphahull_ashapeFromSpectrumRcpp(SEXP spectrumSEXP, SEXP alphaSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const Rcpp::List& >::type spectrum(spectrumSEXP);
+    Rcpp::traits::input_parameter< const double >::type alpha(alphaSEXP);
+    rcpp_result_gen = Rcpp::wrap(ashapeFromSpectrumRcpp(spectrum, alpha));
+    return rcpp_result_gen;
+END_RCPP
+}
+// ashapesFromSpectrumRcpp
+Rcpp::List ashapesFromSpectrumRcpp(const Rcpp::List& spectrum, const Rcpp::NumericVector& alpha, const int threads);
+RcppExport SEXP _RcppAlphahull_ashapesFromSpectrumRcpp(SEXP spectrumSEXP, SEXP alphaSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const Rcpp::List& >::type spectrum(spectrumSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::NumericVector& >::type alpha(alphaSEXP);
+    Rcpp::traits::input_parameter< const int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(ashapesFromSpectrumRcpp(spectrum, alpha, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// ashapeUpdateRcpp
+Rcpp::List ashapeUpdateRcpp(const Rcpp::List& prev, const double alpha);
+RcppExport SEXP _RcppAlphahull_ashapeUpdateRcpp(SEXP prevSEXP, SEXP alphaSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const Rcpp::List& >::type prev(prevSEXP);
+    Rcpp::traits::input_parameter< const double >::type alpha(alphaSEXP);
+    rcpp_result_gen = Rcpp::wrap(ashapeUpdateRcpp(prev, alpha));
+    return rcpp_result_gen;
+END_RCPP
+}
+// computeComplementHandle
+Rcpp::NumericMatrix computeComplementHandle(SEXP handle, const long double& alpha);
+RcppExport SEXP _RcppAlphahull_computeComplementHandle(SEXP handleSEXP, SEXP alphaSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type handle(handleSEXP);
     Rcpp::traits::input_parameter< const long double& >::type alpha(alphaSEXP);
-    rcpp_result_gen = Rcpp::wrap(computeAshapeRcpp(delvor_obj, alpha));
+    rcpp_result_gen = Rcpp::wrap(computeComplementHandle(handle, alpha));
     return rcpp_result_gen;
 END_RCPP
 }
 // computeComplement
-Rcpp::NumericMatrix computeComplement(const Rcpp::NumericMatrix& mesh, const long double& alpha);
-RcppExport SEXP _RcppAlphahull_computeComplement(SEXP meshSEXP, SEXP alphaSEXP) {
+Rcpp::NumericMatrix computeComplement(const Rcpp::NumericMatrix& mesh, const long double& alpha, const std::string precision);
+RcppExport SEXP _RcppAlphahull_computeComplement(SEXP meshSEXP, SEXP alphaSEXP, SEXP precisionSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< const Rcpp::NumericMatrix& >::type mesh(meshSEXP);
     Rcpp::traits::input_parameter< const long double& >::type alpha(alphaSEXP);
-    rcpp_result_gen = Rcpp::wrap(computeComplement(mesh, alpha));
+    Rcpp::traits::input_parameter< const std::string >::type precision(precisionSEXP);
+    rcpp_result_gen = Rcpp::wrap(computeComplement(mesh, alpha, precision));
     return rcpp_result_gen;
 END_RCPP
 }
 // inahullRcpp
-Rcpp::LogicalVector inahullRcpp(const Rcpp::NumericMatrix& complement, const Rcpp::NumericVector& x, const Rcpp::NumericVector& y);
-RcppExport SEXP _RcppAlphahull_inahullRcpp(SEXP complementSEXP, SEXP xSEXP, SEXP ySEXP) {
+Rcpp::LogicalVector inahullRcpp(const Rcpp::NumericMatrix& complement, const Rcpp::NumericVector& x, const Rcpp::NumericVector& y, const std::string precision);
+RcppExport SEXP _RcppAlphahull_inahullRcpp(SEXP complementSEXP, SEXP xSEXP, SEXP ySEXP, SEXP precisionSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< const Rcpp::NumericMatrix& >::type complement(complementSEXP);
     Rcpp::traits::input_parameter< const Rcpp::NumericVector& >::type x(xSEXP);
     Rcpp::traits::input_parameter< const Rcpp::NumericVector& >::type y(ySEXP);
-    rcpp_result_gen = Rcpp::wrap(inahullRcpp(complement, x, y));
+    Rcpp::traits::input_parameter< const std::string >::type precision(precisionSEXP);
+    rcpp_result_gen = Rcpp::wrap(inahullRcpp(complement, x, y, precision));
     return rcpp_result_gen;
 END_RCPP
 }
 // computeVoronoiRcpp
-Rcpp::List computeVoronoiRcpp(const Rcpp::NumericVector x, const Rcpp::NumericVector y);
-RcppExport SEXP _RcppAlphahull_computeVoronoiRcpp(SEXP xSEXP, SEXP ySEXP) {
+Rcpp::List computeVoronoiRcpp(const Rcpp::NumericVector x, const Rcpp::NumericVector y, const int threads, const std::string precision);
+RcppExport SEXP _RcppAlphahull_computeVoronoiRcpp(SEXP xSEXP, SEXP ySEXP, SEXP threadsSEXP, SEXP precisionSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const Rcpp::NumericVector >::type x(xSEXP);
+    Rcpp::traits::input_parameter< const Rcpp::NumericVector >::type y(ySEXP);
+    Rcpp::traits::input_parameter< const int >::type threads(threadsSEXP);
+    Rcpp::traits::input_parameter< const std::string >::type precision(precisionSEXP);
+    rcpp_result_gen = Rcpp::wrap(computeVoronoiRcpp(x, y, threads, precision));
+    return rcpp_result_gen;
+END_RCPP
+}
+// computeVoronoiHandleRcpp
+SEXP computeVoronoiHandleRcpp(const Rcpp::NumericVector x, const Rcpp::NumericVector y, const int threads, const std::string precision);
+RcppExport SEXP _RcppAlphahull_computeVoronoiHandleRcpp(SEXP xSEXP, SEXP ySEXP, SEXP threadsSEXP, SEXP precisionSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< const Rcpp::NumericVector >::type x(xSEXP);
     Rcpp::traits::input_parameter< const Rcpp::NumericVector >::type y(ySEXP);
-    rcpp_result_gen = Rcpp::wrap(computeVoronoiRcpp(x, y));
+    Rcpp::traits::input_parameter< const int >::type threads(threadsSEXP);
+    Rcpp::traits::input_parameter< const std::string >::type precision(precisionSEXP);
+    rcpp_result_gen = Rcpp::wrap(computeVoronoiHandleRcpp(x, y, threads, precision));
+    return rcpp_result_gen;
+END_RCPP
+}
+// delvorHandlePrecision
+std::string delvorHandlePrecision(SEXP handle);
+RcppExport SEXP _RcppAlphahull_delvorHandlePrecision(SEXP handleSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type handle(handleSEXP);
+    rcpp_result_gen = Rcpp::wrap(delvorHandlePrecision(handle));
     return rcpp_result_gen;
 END_RCPP
 }
 
 static const R_CallMethodDef CallEntries[] = {
-    {"_RcppAlphahull_computeAhullRcpp", (DL_FUNC) &_RcppAlphahull_computeAhullRcpp, 1},
-    {"_RcppAlphahull_computeAshapeRcpp", (DL_FUNC) &_RcppAlphahull_computeAshapeRcpp, 2},
-    {"_RcppAlphahull_computeComplement", (DL_FUNC) &_RcppAlphahull_computeComplement, 2},
-    {"_RcppAlphahull_inahullRcpp", (DL_FUNC) &_RcppAlphahull_inahullRcpp, 3},
-    {"_RcppAlphahull_computeVoronoiRcpp", (DL_FUNC) &_RcppAlphahull_computeVoronoiRcpp, 2},
+    {"_RcppAlphahull_computeAhullsRcpp", (DL_FUNC) &_RcppAlphahull_computeAhullsRcpp, 4},
+    {"_RcppAlphahull_computeAhullRcpp", (DL_FUNC) &_RcppAlphahull_computeAhullRcpp, 3},
+    {"_RcppAlphahull_computeAhullHandleRcpp", (DL_FUNC) &_RcppAlphahull_computeAhullHandleRcpp, 2},
+    {"_RcppAlphahull_computeAshapeHandleRcpp", (DL_FUNC) &_RcppAlphahull_computeAshapeHandleRcpp, 2},
+    {"_RcppAlphahull_computeAshapesHandleRcpp", (DL_FUNC) &_RcppAlphahull_computeAshapesHandleRcpp, 3},
+    {"_RcppAlphahull_computeAshapesRcpp", (DL_FUNC) &_RcppAlphahull_computeAshapesRcpp, 4},
+    {"_RcppAlphahull_computeAshapeRcpp", (DL_FUNC) &_RcppAlphahull_computeAshapeRcpp, 4},
+    {"_RcppAlphahull_computeAlphaSpectrumRcpp", (DL_FUNC) &_RcppAlphahull_computeAlphaSpectrumRcpp, 3},
+    {"_RcppAlphahull_ashapeFromSpectrumRcpp", (DL_FUNC) &_RcppAlphahull_ashapeFromSpectrumRcpp, 2},
+    {"_RcppAlphahull_ashapesFromSpectrumRcpp", (DL_FUNC) &_RcppAlphahull_ashapesFromSpectrumRcpp, 3},
+    {"_RcppAlphahull_ashapeUpdateRcpp", (DL_FUNC) &_RcppAlphahull_ashapeUpdateRcpp, 2},
+    {"_RcppAlphahull_computeComplementHandle", (DL_FUNC) &_RcppAlphahull_computeComplementHandle, 2},
+    {"_RcppAlphahull_computeComplement", (DL_FUNC) &_RcppAlphahull_computeComplement, 3},
+    {"_RcppAlphahull_inahullRcpp", (DL_FUNC) &_RcppAlphahull_inahullRcpp, 4},
+    {"_RcppAlphahull_computeVoronoiRcpp", (DL_FUNC) &_RcppAlphahull_computeVoronoiRcpp, 4},
+    {"_RcppAlphahull_computeVoronoiHandleRcpp", (DL_FUNC) &_RcppAlphahull_computeVoronoiHandleRcpp, 4},
+    {"_RcppAlphahull_delvorHandlePrecision", (DL_FUNC) &_RcppAlphahull_delvorHandlePrecision, 1},
     {NULL, NULL, 0}
 };
 
@@ -7,28 +7,51 @@
 #include "newClasses/CircArc.h"
 #include "MyGAL/Vector2.h"
 #include "utilities.h"
+#include "parallel.h"
+#include "delvor_handle.h"
 using namespace Rcpp;
 
-Rcpp::NumericMatrix computeComplement(const Rcpp::NumericMatrix& mesh, const long double& alpha);
+// defined and explicitly instantiated for double and long double in complement_Rcpp.cpp
+template<typename real>
+Rcpp::NumericMatrix computeComplementKernel(const Rcpp::NumericMatrix& mesh, const real& alpha);
+template<typename real>
+DoubleMatrix computeComplementBuffer(const MatrixView& mesh, const real& alpha);
+template<typename real>
+Rcpp::NumericMatrix computeComplementHandleKernel(const DelvorHandle<real>& handle, const real& alpha);
+
+// defined and explicitly instantiated for double and long double in ashape_Rcpp.cpp
+template<typename real>
+Rcpp::List computeAshapesKernel(const Rcpp::List& delvor_obj, const Rcpp::NumericVector& alpha, const int threads);
 
 // starting from the complement matrix of the alpha hull returns a matrix containing arcs that describe
-// the boundary
-template<typename T>
-std::list<CircArc<T>> getArcs(const Rcpp::NumericMatrix& complement){
+// the boundary (M -> Rcpp::NumericMatrix or DoubleMatrix, the latter can be used from worker threads).
+// The arcs are computed and clamped on the given number of threads, their order doesn't depend on it.
+template<typename T, typename M>
+std::list<CircArc<T>> getArcs(const M& complement, const int threads = 1){
   std::vector<Ball<T>> balls;
   std::vector<HalfPlane<T>> halfplanes;
   
   complement_matrix_to_vectors(complement, balls, halfplanes);
  
-  std::list<CircArc<T>> arcs = union_boundary(balls); // construct the boundary of the union of balls
+  std::vector<CircArc<T>> arcs = union_boundary(balls, threads); // construct the boundary of the union of balls
 
   // clamping arcs that are outside the convex hull (namely are in the halfplanes). By construction such
   // arcs have their starting and ending point at most on the boundary of one halfplane so I check if
   // the middle point is in any of them.
-  for(typename std::vector<HalfPlane<T>>::const_iterator hp_it=halfplanes.cbegin(); hp_it!=halfplanes.cend(); hp_it++)
-    arcs.remove_if([&](const CircArc<T>& a){ return hp_it->isIn(a.getMidPoint()); });
+  std::vector<char> outside(arcs.size(), false);
+  parallel_for((arcs.size()+union_chunk_size-1)/union_chunk_size, threads, [&](size_t c){
+    for(size_t i=c*union_chunk_size; i<std::min(arcs.size(), (c+1)*union_chunk_size); i++){
+      Vector2<T> mid = arcs[i].getMidPoint();
+      for(size_t h=0; h<halfplanes.size() && !outside[i]; h++)
+        outside[i] = halfplanes[h].isIn(mid);
+    }
+  });
   
-  return arcs;
+  std::list<CircArc<T>> res;
+  for(size_t i=0; i<arcs.size(); i++)
+    if(!outside[i])
+      res.push_back(arcs[i]);
+  return res;
 }
 
 // given the arcs that form the boundary of the alpha-hull return its length
@@ -40,24 +63,14 @@ T ahull_boundary_length(const std::list<CircArc<T>>& arcs){
   return length;
 }
 
-/* Function to retrieve a ahull object (almost) like the one returned by the alphahull function ahull,
- * but emplying previous results from the c++ library MyGAL
+/* Builds the ahull object of the given ashape object from the complement of the alpha-hull and the arcs of
+ * its boundary
+ * 
+ * real -> floating point representation to be used
  */
-// [[Rcpp::export(".computeAhullRcpp")]]
-Rcpp::List computeAhullRcpp(Rcpp::List ashape) {
-  // choosing the floating point representation to be used
-  typedef long double real;
-
-  // Retrieve the complement of the alpha-hull
-  Rcpp::NumericMatrix mesh = as<Rcpp::List>(ashape["delvor.obj"])["mesh"];
-  const real alpha = ashape["alpha"];
-
-  // the complement is a union of open balls and open halfplanes
-  Rcpp::NumericMatrix complement = computeComplement(mesh, alpha);
-
-  // arcs of the boundary of the alpha-hull
-  std::list<CircArc<real>> arcs = getArcs<real>(complement);
-  
+template<typename real>
+Rcpp::List makeAhull(const Rcpp::List& ashape, const Rcpp::NumericMatrix& complement,
+                     const std::list<CircArc<real>>& arcs) {
   // building arcs matrix
   Rcpp::NumericMatrix arcs_mat(arcs.size(), 8);
   std::vector<real> c1, c2, r, vx, vy, alpha_mid;
@@ -104,3 +117,92 @@ Rcpp::List computeAhullRcpp(Rcpp::List ashape) {
 
   return ahull;
 }
+
+/* Function to retrieve a ahull object (almost) like the one returned by the alphahull function ahull,
+ * but emplying previous results from the c++ library MyGAL
+ * 
+ * real -> floating point representation to be used
+ */
+template<typename real>
+Rcpp::List computeAhullKernel(const Rcpp::List& ashape, const int threads) {
+
+  // Retrieve the complement of the alpha-hull
+  Rcpp::NumericMatrix mesh = as<Rcpp::List>(ashape["delvor.obj"])["mesh"];
+  const real alpha = ashape["alpha"];
+
+  // the complement is a union of open balls and open halfplanes
+  Rcpp::NumericMatrix complement = computeComplementKernel<real>(mesh, alpha);
+
+  // arcs of the boundary of the alpha-hull
+  std::list<CircArc<real>> arcs = getArcs<real>(complement, threads);
+
+  return makeAhull<real>(ashape, complement, arcs);
+}
+
+template Rcpp::List computeAhullKernel<double>(const Rcpp::List&, const int);
+template Rcpp::List computeAhullKernel<long double>(const Rcpp::List&, const int);
+
+// Same as computeAhullKernel for an ashape object computed from a native delvor object (see delvor_handle.h)
+template<typename real>
+Rcpp::List computeAhullHandleKernel(const Rcpp::List& ashape, const int threads) {
+  const DelvorHandle<real>& handle = as_handle<real>(ashape["delvor.obj"]);
+  const real alpha = ashape["alpha"];
+
+  Rcpp::NumericMatrix complement = computeComplementHandleKernel<real>(handle, alpha);
+  std::list<CircArc<real>> arcs = getArcs<real>(complement, threads);
+
+  return makeAhull<real>(ashape, complement, arcs);
+}
+
+/* Computes the alpha-hulls for several values of alpha from the same delvor object: the alpha-shapes are
+ * computed by computeAshapesKernel, then the complement and the arcs of each alpha-hull are computed on
+ * worker threads. Returns a list with an ahull object for each value of alpha.
+ * 
+ * real -> floating point representation to be used
+ */
+template<typename real>
+Rcpp::List computeAhullsKernel(const Rcpp::List& delvor_obj, const Rcpp::NumericVector& alpha, const int threads) {
+  Rcpp::List ashapes = computeAshapesKernel<real>(delvor_obj, alpha, threads);
+
+  const Rcpp::NumericMatrix mesh = delvor_obj["mesh"];
+  MatrixView mesh_view(mesh);
+  std::vector<DoubleMatrix> complements(alpha.size());
+  std::vector<std::list<CircArc<real>>> arcs(alpha.size());
+  std::vector<real> alphas(alpha.begin(), alpha.end());
+  parallel_for(alphas.size(), threads, [&](size_t k){
+    complements[k] = computeComplementBuffer<real>(mesh_view, alphas[k]);
+    arcs[k] = getArcs<real>(complements[k]);
+  });
+
+  Rcpp::List ahulls(alphas.size());
+  for(size_t k=0; k<alphas.size(); k++){
+    Rcpp::List ashape = ashapes[k];
+    Rcpp::NumericMatrix complement = complements[k].toRcpp();
+    colnames(complement) = complement_colnames();
+    ahulls[k] = makeAhull<real>(ashape, complement, arcs[k]);
+  }
+
+  return ahulls;
+}
+
+// [[Rcpp::export(".computeAhullsRcpp")]]
+Rcpp::List computeAhullsRcpp(const Rcpp::List& delvor_obj, const Rcpp::NumericVector& alpha, const int threads = 1,
+                             const std::string precision = "long double") {
+  if(as_precision(precision) == Precision::Double)
+    return computeAhullsKernel<double>(delvor_obj, alpha, threads);
+  return computeAhullsKernel<long double>(delvor_obj, alpha, threads);
+}
+
+// [[Rcpp::export(".computeAhullRcpp")]]
+Rcpp::List computeAhullRcpp(Rcpp::List ashape, const int threads = 1, const std::string precision = "long double") {
+  if(as_precision(precision) == Precision::Double)
+    return computeAhullKernel<double>(ashape, threads);
+  return computeAhullKernel<long double>(ashape, threads);
+}
+
+// [[Rcpp::export(".computeAhullHandleRcpp")]]
+Rcpp::List computeAhullHandleRcpp(Rcpp::List ashape, const int threads = 1) {
+  if(handle_precision(ashape["delvor.obj"]) == Precision::Double)
+    return computeAhullHandleKernel<double>(ashape, threads);
+  return computeAhullHandleKernel<long double>(ashape, threads);
+}
@@ -1,8 +1,13 @@
 #include <Rcpp.h>
 #include <iostream>
 #include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <numeric>
 #include "newClasses/Segment.h"
 #include "utilities.h"
+#include "parallel.h"
+#include "delvor_handle.h"
 using namespace mygal;
 using namespace Rcpp;
 
@@ -10,89 +15,77 @@ using namespace Rcpp;
  * one can show that for each site of the diagram it holds
  * p=(x;y) alpha-extreme for any alpha <= alpha^i_L
  * alpha^i_L = max( dist(p,v), v vertex of face of point p in the voronoi diagram )
+ * The edges are processed on the given number of threads (see alphaLimits).
  */
 template<typename T>
-std::vector<T> computeAlphaLimits(const Rcpp::List& delvor_obj){
-   std::vector<T> alpha_L((int) as<Rcpp::List>(delvor_obj["tri.obj"])["n"], 0); // vector to store the limit values
+std::vector<T> computeAlphaLimits(const Rcpp::List& delvor_obj, const int threads = 1){
    const Rcpp::NumericMatrix& mesh = delvor_obj["mesh"];
-   for(int i=0; i<mesh.rows(); i++){
-      size_t idx1 = (mesh(i,0)-1), idx2 = (mesh(i,1)-1); // retrieving 1st and 2nd site indices
-      if(mesh(i,10) == 1 || mesh(i,11) == 1){ 
-         // if the edge is infinite then the sites are alpha-extreme for any alpha, for simplicity I set
-         // to infinite their limit values
-         alpha_L[idx1] = std::numeric_limits<T>::infinity();
-         alpha_L[idx2] = std::numeric_limits<T>::infinity();
-      }
-      else{
-         Vector2<T>  p(mesh(i,2), mesh(i,3)); // 1st site
-         Vector2<T> e1(mesh(i,6), mesh(i,7)); // 1st endpoint of the current Voronoi edge
-         Vector2<T> e2(mesh(i,8), mesh(i,9)); // 2nd endpoint of the current Voronoi edge
-
-         T dist1 = p.getDistance(e1); // distance from p to e1
-         T dist2 = p.getDistance(e2); // distance from p to e2
-         T tmp = std::max(dist1, dist2);
-         alpha_L[idx1] = std::max(alpha_L[idx1], tmp); // updating the limit value for the 1st site
-         alpha_L[idx2] = std::max(alpha_L[idx2], tmp); // updating the limit value for the 2nd site
-      }
-   }
-
-   return alpha_L;
+   return alphaLimits<T>(mesh_columns(mesh), (int) as<Rcpp::List>(delvor_obj["tri.obj"])["n"], threads);
 }
 
-/* Returns which rows of the matrix mesh are part of the alpha hull for the given value of alpha (recall
- * that the alpha-shape is a subset of the Delaunay triangulation)
- * 
- * T -> precision of floating point
- * T2 -> type for the indices (size_t or int)
- * 
+/* Fills the cache of a native delvor object: distances and interval of alpha of each edge, alpha-limits of
+ * the sites, computed on the given number of threads.
  */
-template<typename T, typename T2>
-std::vector<T2> getAlphaNeighbours(const Rcpp::NumericMatrix& mesh,
-                                   const std::vector<T2>& alpha_extremes,
-                                   const T& alpha){
-   std::vector<T2> which_rows;
-   for(int i=0; i<mesh.rows(); i++)
-      if(std::find(alpha_extremes.begin(), alpha_extremes.end(), mesh(i,0)) != alpha_extremes.end()
-         && std::find(alpha_extremes.begin(), alpha_extremes.end(), mesh(i,1)) != alpha_extremes.end()){
-         // checking alpha_min e alpha_max
-         Vector2<T>  p(mesh(i,2), mesh(i,3));
-         Vector2<T>  q(mesh(i,4), mesh(i,5));
-         Vector2<T> e1(mesh(i,6), mesh(i,7));
-         Vector2<T> e2(mesh(i,8), mesh(i,9));
-
-         T dist1 = (mesh(i,10) == 1? std::numeric_limits<T>::infinity(): p.getDistance(e1));
-         T dist2 = (mesh(i,11) == 1? std::numeric_limits<T>::infinity(): p.getDistance(e2));
-         T dist3 = p.getDistance(q);
+template<typename real>
+void computeHandleCache(DelvorHandle<real>& handle, const int threads){
+   const MeshColumns mesh = mesh_columns(handle.mesh);
+   handle.dist1.resize(mesh.rows());
+   handle.dist2.resize(mesh.rows());
+   handle.alpha_min.resize(mesh.rows());
+   handle.alpha_max.resize(mesh.rows());
+   edgeAlphaIntervals(mesh, 0, mesh.rows(), handle.alpha_min.data(), handle.alpha_max.data(), handle.dist1.data(),
+                      handle.dist2.data(), threads);
+   handle.alpha_limits = alphaLimits<real>(mesh, handle.nb_sites(), threads);
+}
 
-         Segment<T> s1(p,q), s2(e1, e2);
+template void computeHandleCache<double>(DelvorHandle<double>&, const int);
+template void computeHandleCache<long double>(DelvorHandle<long double>&, const int);
 
-         T alpha_min = (s1.intersect(s2)? dist3/2: std::min(dist1, dist2));
-         T alpha_max = std::max(dist1, dist2);
+// Copies the given rows of the matrix mesh in a new matrix, column by column
+inline Rcpp::NumericMatrix meshRows(const MeshColumns& mesh, const std::vector<size_t>& which_rows){
+   Rcpp::NumericMatrix edges(which_rows.size(), mesh.cols());
+   for(int j=0; j<mesh.cols(); j++)
+      for(size_t i=0; i<which_rows.size(); i++)
+         edges(i,j) = mesh(which_rows[i],j);
+   return edges;
+}
 
-         if(alpha_min <= alpha && alpha <= alpha_max)
-            which_rows.push_back(i);
-      }
+// Builds the ashape object of delvor_obj made of the given edges (rows of its mesh) and length
+template<typename real>
+Rcpp::List makeAshape(const Rcpp::List& delvor_obj, const Rcpp::NumericMatrix& edges, const real& length,
+                      const real& alpha, const std::vector<size_t>& alpha_extremes){
+   Rcpp::List ashape = Rcpp::List::create(Rcpp::Named("edges") = edges,
+                                          Rcpp::Named("length") = length,
+                                          Rcpp::Named("alpha") = alpha,
+                                          Rcpp::Named("alpha.extremes") = as<Rcpp::IntegerVector>(alpha_extremes),
+                                          Rcpp::Named("delvor.obj") = delvor_obj,
+                                          Rcpp::Named("x") = delvor_obj["x"]);
+   ashape.attr("class") = "ashape";
 
-   return which_rows;
+   return ashape;
 }
 
-// Computes the length of the alpha-shape given the mesh matrix describing it
-template<typename T>
-T ashape_length(const Rcpp::NumericMatrix& mesh){
-   T length = 0;
-   for(int i=0; i<mesh.rows(); i++){
-      Vector2<T> p(mesh(i,2), mesh(i,3));
-      Vector2<T> q(mesh(i,4), mesh(i,5));
-      length+=p.getDistance(q);
-   }
-   return length;
+/* Builds the ashape object made of the given rows of the mesh of delvor_obj
+ * 
+ * real -> floating point representation used for the length
+ */
+template<typename real>
+Rcpp::List makeAshape(const Rcpp::List& delvor_obj, const std::vector<size_t>& which_rows, const real& alpha,
+                      const std::vector<size_t>& alpha_extremes){
+   // Extracting the needed rows
+   Rcpp::NumericMatrix mesh = delvor_obj["mesh"];
+   Rcpp::NumericMatrix edges = meshRows(mesh_columns(mesh), which_rows);
+   colnames(edges) = colnames(mesh);
+
+   return makeAshape<real>(delvor_obj, edges, alphaShapeLength<real>(mesh_columns(edges)), alpha, alpha_extremes);
 }
 
-// [[Rcpp::export(".computeAshapeRcpp")]]
-Rcpp::List computeAshapeRcpp(const Rcpp::List& delvor_obj, const long double& alpha) {
-   // choosing the floating point representation to be used
-   typedef long double real;
-   
+/* Computes the alpha-shape from a delvor object
+ * 
+ * real -> floating point representation to be used
+ */
+template<typename real>
+Rcpp::List computeAshapeKernel(const Rcpp::List& delvor_obj, const real& alpha, const int threads) {
   /* delvor_obj has to be a "delvor" object and therefore is a list with the following components:
    * - mesh: matrix containing information about the voronoi tesselation and Delaunay
    *   triangulation relative to the sites contained in the 2nd element of the list
@@ -106,32 +99,420 @@ Rcpp::List computeAshapeRcpp(const Rcpp::List& delvor_obj, const long double& al
    * p=(x;y) alpha-extreme for any alpha <= alpha^i_L
    * alpha^i_L = max( dist(p,v), v vertex of face of point p in the voronoi diagram )
    */
-   std::vector<real> alpha_L = computeAlphaLimits<real>(delvor_obj);
+   std::vector<real> alpha_L = computeAlphaLimits<real>(delvor_obj, threads);
 
-   // Select the alpha-extreme sites
+   // Select the alpha-extreme sites, their indices (starting from 1) and a flag for each site
    std::vector<size_t> alpha_extremes;
-   for(size_t i=0; i<(size_t) as<Rcpp::List>(delvor_obj["tri.obj"])["n"]; i++)
-        if(alpha <= alpha_L[i])
-           alpha_extremes.push_back(i+1);
+   const std::vector<bool> is_alpha_extreme = alphaExtremes(alpha_L, alpha, alpha_extremes);
         
-   // Select the alpha-neighbours rows of the matrix mesh
-   std::vector<size_t> which_rows = getAlphaNeighbours<real>(delvor_obj["mesh"], alpha_extremes, alpha);
+   // Select the alpha-neighbours rows of the matrix mesh (recall that the alpha-shape is a subset of the
+   // Delaunay triangulation)
+   const Rcpp::NumericMatrix& mesh = delvor_obj["mesh"];
+   const MeshColumns columns = mesh_columns(mesh);
+   if(nb_edge_chunks(columns.rows(), threads) > 1){
+      std::vector<size_t> which_rows = alphaShapeEdges<real>(columns, is_alpha_extreme, alpha, threads);
+      return makeAshape<real>(delvor_obj, which_rows, alpha, alpha_extremes);
+   }
 
-   // Extracting the needed rows
-   Rcpp::NumericMatrix mesh = delvor_obj["mesh"];
-   Rcpp::NumericMatrix edges(which_rows.size(), mesh.cols());
+   // On a single thread the length is accumulated while the rows are selected, then the rows are copied
+   // column by column in the output, allocated once their number is known
+   EdgeMask selected(columns.rows());
+   const real length = alphaShapeSelect<real>(columns, is_alpha_extreme, alpha, selected);
+   Rcpp::NumericMatrix edges(selected.count, columns.cols());
+   if(selected.count > 0)
+      copyEdges(columns, selected, &edges[0]);
    colnames(edges) = colnames(mesh);
-   for(size_t i=0; i<which_rows.size(); i++)
-      edges(i,_) = mesh(which_rows[i],_);
+
+   return makeAshape<real>(delvor_obj, edges, length, alpha, alpha_extremes);
+}
+
+template Rcpp::List computeAshapeKernel<double>(const Rcpp::List&, const double&, const int);
+template Rcpp::List computeAshapeKernel<long double>(const Rcpp::List&, const long double&, const int);
+
+/* Computes the alpha-shapes for several values of alpha from the same delvor object: the alpha-limits of the
+ * sites and the intervals of the edges are computed once, then the sites and the rows of each alpha-shape are
+ * selected on worker threads (the selection is the one of computeAshapeKernel). Returns a list with an ashape
+ * object for each value of alpha, all sharing the same delvor object.
+ * 
+ * real -> floating point representation to be used
+ */
+template<typename real>
+Rcpp::List computeAshapesKernel(const Rcpp::List& delvor_obj, const Rcpp::NumericVector& alpha, const int threads) {
+   std::vector<real> alpha_L = computeAlphaLimits<real>(delvor_obj, threads);
+
+   // single pass over the mesh: interval of each edge
+   const Rcpp::NumericMatrix& mesh_matrix = delvor_obj["mesh"];
+   const MeshColumns mesh = mesh_columns(mesh_matrix);
+   std::vector<real> alpha_min(mesh.rows()), alpha_max(mesh.rows());
+   edgeAlphaIntervals(mesh, 0, mesh.rows(), alpha_min.data(), alpha_max.data(), (real*) nullptr, (real*) nullptr,
+                      threads);
+
+   std::vector<real> alphas(alpha.begin(), alpha.end());
+   std::vector<std::vector<size_t>> alpha_extremes(alphas.size()), which_rows(alphas.size());
+   parallel_for(alphas.size(), threads, [&](size_t k){
+      const std::vector<bool> is_alpha_extreme = alphaExtremes(alpha_L, alphas[k], alpha_extremes[k]);
+      forEachAlphaShapeEdge(mesh, 0, mesh.rows(), is_alpha_extreme, alphas[k], alpha_min.data(), alpha_max.data(),
+                            [&](size_t i){ which_rows[k].push_back(i); });
+   });
+
+   Rcpp::List ashapes(alphas.size());
+   for(size_t k=0; k<alphas.size(); k++)
+      ashapes[k] = makeAshape<real>(delvor_obj, which_rows[k], alphas[k], alpha_extremes[k]);
+
+   return ashapes;
+}
+
+template Rcpp::List computeAshapesKernel<double>(const Rcpp::List&, const Rcpp::NumericVector&, const int);
+template Rcpp::List computeAshapesKernel<long double>(const Rcpp::List&, const Rcpp::NumericVector&, const int);
+
+// Builds the ashape object made of the given rows of the mesh of a native delvor object (see delvor_handle.h)
+template<typename real>
+Rcpp::List makeHandleAshape(SEXP handle_ptr, const MeshColumns& mesh, const std::vector<size_t>& which_rows,
+                            const real& alpha, const std::vector<size_t>& alpha_extremes){
+   Rcpp::NumericMatrix edges = meshRows(mesh, which_rows);
+   colnames(edges) = mesh_colnames();
 
    Rcpp::List ashape = Rcpp::List::create(Rcpp::Named("edges") = edges,
-                                          Rcpp::Named("length") = ashape_length<real>(edges),
+                                          Rcpp::Named("length") = alphaShapeLength<real>(mesh_columns(edges)),
                                           Rcpp::Named("alpha") = alpha,
                                           Rcpp::Named("alpha.extremes") = as<Rcpp::IntegerVector>(alpha_extremes),
-                                          Rcpp::Named("delvor.obj") = delvor_obj,
-                                          Rcpp::Named("x") = delvor_obj["x"]);
+                                          Rcpp::Named("delvor.obj") = handle_ptr);
    ashape.attr("class") = "ashape";
 
    return ashape;
 }
 
+/* Computes the alpha-shape from a native delvor object (see delvor_handle.h): the selection is the one of
+ * computeAshapeKernel with the alpha-limits and the intervals read from the cache of the handle. The field
+ * delvor.obj of the result is the handle and there is no field x.
+ * 
+ * real -> floating point representation used to build the handle
+ */
+template<typename real>
+Rcpp::List computeAshapeHandleKernel(SEXP handle_ptr, const real& alpha) {
+   const DelvorHandle<real>& handle = as_handle<real>(handle_ptr);
+
+   std::vector<size_t> alpha_extremes;
+   const std::vector<bool> is_alpha_extreme = alphaExtremes(handle.alpha_limits, alpha, alpha_extremes);
+
+   const MeshColumns mesh = mesh_columns(handle.mesh);
+   std::vector<size_t> which_rows;
+   forEachAlphaShapeEdge(mesh, 0, mesh.rows(), is_alpha_extreme, alpha, handle.alpha_min.data(),
+                         handle.alpha_max.data(), [&](size_t i){ which_rows.push_back(i); });
+
+   return makeHandleAshape<real>(handle_ptr, mesh, which_rows, alpha, alpha_extremes);
+}
+
+/* Computes the alpha-shapes for several values of alpha from a native delvor object: the sites and the rows of
+ * each alpha-shape are selected on worker threads from the cache of the handle, as in computeAshapesKernel.
+ * Returns a list with an ashape object for each value of alpha (see computeAshapeHandleKernel).
+ * 
+ * real -> floating point representation used to build the handle
+ */
+template<typename real>
+Rcpp::List computeAshapesHandleKernel(SEXP handle_ptr, const Rcpp::NumericVector& alpha, const int threads) {
+   const DelvorHandle<real>& handle = as_handle<real>(handle_ptr);
+   const MeshColumns mesh = mesh_columns(handle.mesh);
+
+   std::vector<real> alphas(alpha.begin(), alpha.end());
+   std::vector<std::vector<size_t>> alpha_extremes(alphas.size()), which_rows(alphas.size());
+   parallel_for(alphas.size(), threads, [&](size_t k){
+      const std::vector<bool> is_alpha_extreme = alphaExtremes(handle.alpha_limits, alphas[k], alpha_extremes[k]);
+      forEachAlphaShapeEdge(mesh, 0, mesh.rows(), is_alpha_extreme, alphas[k], handle.alpha_min.data(),
+                            handle.alpha_max.data(), [&](size_t i){ which_rows[k].push_back(i); });
+   });
+
+   Rcpp::List ashapes(alphas.size());
+   for(size_t k=0; k<alphas.size(); k++)
+      ashapes[k] = makeHandleAshape<real>(handle_ptr, mesh, which_rows[k], alphas[k], alpha_extremes[k]);
+
+   return ashapes;
+}
+
+// [[Rcpp::export(".computeAshapeHandleRcpp")]]
+Rcpp::List computeAshapeHandleRcpp(SEXP handle, const long double& alpha) {
+   if(handle_precision(handle) == Precision::Double)
+      return computeAshapeHandleKernel<double>(handle, alpha);
+   return computeAshapeHandleKernel<long double>(handle, alpha);
+}
+
+// [[Rcpp::export(".computeAshapesHandleRcpp")]]
+Rcpp::List computeAshapesHandleRcpp(SEXP handle, const Rcpp::NumericVector& alpha, const int threads = 1) {
+   if(handle_precision(handle) == Precision::Double)
+      return computeAshapesHandleKernel<double>(handle, alpha, threads);
+   return computeAshapesHandleKernel<long double>(handle, alpha, threads);
+}
+
+// [[Rcpp::export(".computeAshapesRcpp")]]
+Rcpp::List computeAshapesRcpp(const Rcpp::List& delvor_obj, const Rcpp::NumericVector& alpha, const int threads = 1,
+                              const std::string precision = "long double") {
+   if(as_precision(precision) == Precision::Double)
+      return computeAshapesKernel<double>(delvor_obj, alpha, threads);
+   return computeAshapesKernel<long double>(delvor_obj, alpha, threads);
+}
+
+// [[Rcpp::export(".computeAshapeRcpp")]]
+Rcpp::List computeAshapeRcpp(const Rcpp::List& delvor_obj, const long double& alpha, const int threads = 1,
+                             const std::string precision = "long double") {
+   if(as_precision(precision) == Precision::Double)
+      return computeAshapeKernel<double>(delvor_obj, alpha, threads);
+   return computeAshapeKernel<long double>(delvor_obj, alpha, threads);
+}
+
+/* The alpha-spectrum of a delvor object stores what computeAshapeKernel computes for any alpha: the
+ * alpha-limits of the sites and the interval [alpha_min, alpha_max] of each row of the mesh. The intervals
+ * are sorted by alpha_min so that the alpha-shape for a given alpha is found with a binary search followed
+ * by a scan of the rows with alpha_min <= alpha.
+ *
+ * The values are stored as doubles. Since alpha comes from R as a double, rounding alpha_min up and
+ * alpha_max and the alpha-limits down keeps every comparison with alpha exact: the alpha-shape obtained from
+ * the spectrum is the one that computeAshapeKernel<real> returns.
+ */
+
+// nearest double not greater (up = false) or not smaller (up = true) than x
+template<typename T>
+double round_to_double(const T& x, bool up){
+   double d = static_cast<double>(x);
+   if(up && d < x)
+      return std::nextafter(d, std::numeric_limits<double>::infinity());
+   if(!up && d > x)
+      return std::nextafter(d, -std::numeric_limits<double>::infinity());
+   return d;
+}
+
+template<typename real>
+Rcpp::List computeAlphaSpectrumKernel(const Rcpp::List& delvor_obj, const std::string& precision, const int threads) {
+   std::vector<real> alpha_L = computeAlphaLimits<real>(delvor_obj, threads);
+   Rcpp::NumericVector alpha_limits(alpha_L.size());
+   for(size_t i=0; i<alpha_L.size(); i++)
+      alpha_limits[i] = round_to_double(alpha_L[i], false);
+
+   const Rcpp::NumericMatrix& mesh = delvor_obj["mesh"];
+   std::vector<real> a_min(mesh.rows()), a_max(mesh.rows());
+   edgeAlphaIntervals(mesh_columns(mesh), 0, mesh.rows(), a_min.data(), a_max.data(), (real*) nullptr,
+                      (real*) nullptr, threads);
+   std::vector<double> alpha_min(mesh.rows()), alpha_max(mesh.rows());
+   for(int i=0; i<mesh.rows(); i++){
+      alpha_min[i] = round_to_double(a_min[i], true);
+      alpha_max[i] = round_to_double(a_max[i], false);
+   }
+   std::vector<int> order(mesh.rows());
+   std::iota(order.begin(), order.end(), 0);
+   std::stable_sort(order.begin(), order.end(), [&](int i, int j){ return alpha_min[i] < alpha_min[j]; });
+
+   Rcpp::NumericMatrix intervals(mesh.rows(), 3);
+   colnames(intervals) = Rcpp::CharacterVector{"row", "alpha.min", "alpha.max"};
+   for(int k=0; k<mesh.rows(); k++){
+      intervals(k,0) = order[k] + 1;
+      intervals(k,1) = alpha_min[order[k]];
+      intervals(k,2) = alpha_max[order[k]];
+   }
+
+   // orders used to update an alpha-shape (see ashapeUpdateKernel): rows of intervals by alpha.max and sites
+   // by alpha-limit, starting from 1
+   Rcpp::IntegerVector max_order(mesh.rows()), limits_order(alpha_limits.size());
+   std::iota(max_order.begin(), max_order.end(), 1);
+   std::stable_sort(max_order.begin(), max_order.end(), [&](int k, int l){ return intervals(k-1,2) < intervals(l-1,2); });
+   std::iota(limits_order.begin(), limits_order.end(), 1);
+   std::stable_sort(limits_order.begin(), limits_order.end(),
+                    [&](int i, int j){ return alpha_limits[i-1] < alpha_limits[j-1]; });
+
+   Rcpp::List spectrum = Rcpp::List::create(Rcpp::Named("intervals") = intervals,
+                                            Rcpp::Named("alpha.limits") = alpha_limits,
+                                            Rcpp::Named("max.order") = max_order,
+                                            Rcpp::Named("limits.order") = limits_order,
+                                            Rcpp::Named("precision") = precision,
+                                            Rcpp::Named("delvor.obj") = delvor_obj,
+                                            Rcpp::Named("x") = delvor_obj["x"]);
+   spectrum.attr("class") = "alphaspectrum";
+
+   return spectrum;
+}
+
+// [[Rcpp::export(".computeAlphaSpectrumRcpp")]]
+Rcpp::List computeAlphaSpectrumRcpp(const Rcpp::List& delvor_obj, const int threads = 1,
+                                    const std::string precision = "long double") {
+   if(as_precision(precision) == Precision::Double)
+      return computeAlphaSpectrumKernel<double>(delvor_obj, precision, threads);
+   return computeAlphaSpectrumKernel<long double>(delvor_obj, precision, threads);
+}
+
+/* Builds the ashape object made of the given rows of the mesh of the delvor object of an alpha-spectrum (see
+ * makeAshape), with two more fields used by ashapeUpdateKernel: the spectrum and the rows (starting from 1)
+ */
+template<typename real>
+Rcpp::List makeSpectrumAshape(const Rcpp::List& spectrum, const std::vector<size_t>& which_rows, const double alpha,
+                              const std::vector<size_t>& alpha_extremes) {
+   Rcpp::List ashape = makeAshape<real>(spectrum["delvor.obj"], which_rows, (real) alpha, alpha_extremes);
+   Rcpp::IntegerVector rows(which_rows.size());
+   for(size_t i=0; i<which_rows.size(); i++)
+      rows[i] = which_rows[i] + 1;
+   ashape.push_back(spectrum, "spectrum");
+   ashape.push_back(rows, "rows");
+   ashape.attr("class") = "ashape"; // push_back drops the attributes other than the names
+
+   return ashape;
+}
+
+/* Selects the alpha-shape of an alpha-spectrum for the given value of alpha: appends the alpha-extremes
+ * (indices starting from 1) to alpha_extremes and the rows of the mesh (starting from 0, in the order of the
+ * mesh) to which_rows. No distance is computed, the rows whose interval contains alpha are among the ones with
+ * alpha_min <= alpha, found by binary search. Their sites are alpha-extremes (alpha_max is the distance from
+ * the sites to the farthest extreme of the Voronoi edge, which is not greater than their alpha-limits), so only
+ * alpha_max has to be checked. The spectrum is read through views, so the selection can run on worker threads.
+ */
+inline void spectrumSelection(const MatrixView& intervals, const std::vector<double>& alpha_limits,
+                              const double alpha, std::vector<size_t>& alpha_extremes,
+                              std::vector<size_t>& which_rows){
+   for(size_t i=0; i<alpha_limits.size(); i++)
+      if(alpha <= alpha_limits[i])
+         alpha_extremes.push_back(i+1);
+
+   // the column alpha.min is sorted
+   int nb_candidates = 0;
+   if(intervals.rows() > 0){
+      const double* alpha_min = intervals.data + intervals.rows();
+      nb_candidates = std::upper_bound(alpha_min, alpha_min + intervals.rows(), alpha) - alpha_min;
+   }
+   for(int k=0; k<nb_candidates; k++)
+      if(alpha <= intervals(k,2))
+         which_rows.push_back(intervals(k,0) - 1);
+   std::sort(which_rows.begin(), which_rows.end()); // same order as the mesh
+}
+
+// Computes the alpha-shape from an alpha-spectrum (see spectrumSelection)
+template<typename real>
+Rcpp::List ashapeFromSpectrumKernel(const Rcpp::List& spectrum, const double alpha) {
+   const Rcpp::NumericMatrix& intervals = spectrum["intervals"];
+   const Rcpp::NumericVector& alpha_limits = spectrum["alpha.limits"];
+
+   std::vector<size_t> alpha_extremes, which_rows;
+   spectrumSelection(MatrixView(intervals), std::vector<double>(alpha_limits.begin(), alpha_limits.end()), alpha,
+                     alpha_extremes, which_rows);
+
+   return makeSpectrumAshape<real>(spectrum, which_rows, alpha, alpha_extremes);
+}
+
+/* Computes the alpha-shapes for several values of alpha from an alpha-spectrum: each one is selected on a
+ * worker thread (see spectrumSelection). Returns a list with an ashape object for each value of alpha.
+ */
+template<typename real>
+Rcpp::List ashapesFromSpectrumKernel(const Rcpp::List& spectrum, const Rcpp::NumericVector& alpha,
+                                     const int threads) {
+   const Rcpp::NumericMatrix& intervals_matrix = spectrum["intervals"];
+   const Rcpp::NumericVector& alpha_limits_vector = spectrum["alpha.limits"];
+   const MatrixView intervals(intervals_matrix);
+   const std::vector<double> alpha_limits(alpha_limits_vector.begin(), alpha_limits_vector.end());
+
+   std::vector<double> alphas(alpha.begin(), alpha.end());
+   std::vector<std::vector<size_t>> alpha_extremes(alphas.size()), which_rows(alphas.size());
+   parallel_for(alphas.size(), threads, [&](size_t k){
+      spectrumSelection(intervals, alpha_limits, alphas[k], alpha_extremes[k], which_rows[k]);
+   });
+
+   Rcpp::List ashapes(alphas.size());
+   for(size_t k=0; k<alphas.size(); k++)
+      ashapes[k] = makeSpectrumAshape<real>(spectrum, which_rows[k], alphas[k], alpha_extremes[k]);
+
+   return ashapes;
+}
+
+// [[Rcpp::export(".ashapeFromSpectrumRcpp")]]
+Rcpp::List ashapeFromSpectrumRcpp(const Rcpp::List& spectrum, const double alpha) {
+   if(as_precision(Rcpp::as<std::string>(spectrum["precision"])) == Precision::Double)
+      return ashapeFromSpectrumKernel<double>(spectrum, alpha);
+   return ashapeFromSpectrumKernel<long double>(spectrum, alpha);
+}
+
+// [[Rcpp::export(".ashapesFromSpectrumRcpp")]]
+Rcpp::List ashapesFromSpectrumRcpp(const Rcpp::List& spectrum, const Rcpp::NumericVector& alpha,
+                                   const int threads = 1) {
+   if(as_precision(Rcpp::as<std::string>(spectrum["precision"])) == Precision::Double)
+      return ashapesFromSpectrumKernel<double>(spectrum, alpha, threads);
+   return ashapesFromSpectrumKernel<long double>(spectrum, alpha, threads);
+}
+
+// Elements of the sorted vector v, without the ones of the sorted vector removed, with the ones of the sorted
+// vector added
+inline std::vector<size_t> updateSorted(const std::vector<size_t>& v, const std::vector<size_t>& removed,
+                                        const std::vector<size_t>& added){
+   std::vector<size_t> kept, res;
+   kept.reserve(v.size());
+   std::set_difference(v.begin(), v.end(), removed.begin(), removed.end(), std::back_inserter(kept));
+   res.reserve(kept.size()+added.size());
+   std::merge(kept.begin(), kept.end(), added.begin(), added.end(), std::back_inserter(res));
+   return res;
+}
+
+/* Updates an alpha-shape obtained from an alpha-spectrum (see makeSpectrumAshape) to a new value of alpha.
+ * Let lo and hi be the smallest and the largest of the old and the new alpha, an edge changes its membership
+ * if and only if
+ * - alpha.min is in (lo, hi] and alpha.max >= hi: it enters the alpha-shape when alpha grows, it leaves it
+ *   when alpha decreases;
+ * - alpha.max is in [lo, hi) and alpha.min <= lo: it leaves the alpha-shape when alpha grows, it enters it
+ *   when alpha decreases;
+ * and a site changes its membership to the alpha-extremes if and only if its alpha-limit is in [lo, hi). The
+ * three ranges are found by binary search on the orders of the spectrum, so only the rows and the sites whose
+ * bounds are between the two values of alpha are visited; the result is the one of ashapeFromSpectrumKernel.
+ */
+template<typename real>
+Rcpp::List ashapeUpdateKernel(const Rcpp::List& prev, const double alpha) {
+   const Rcpp::List& spectrum = prev["spectrum"];
+   const Rcpp::NumericMatrix& intervals = spectrum["intervals"];
+   const Rcpp::NumericVector& alpha_limits = spectrum["alpha.limits"];
+   const Rcpp::IntegerVector& max_order = spectrum["max.order"];
+   const Rcpp::IntegerVector& limits_order = spectrum["limits.order"];
+   const double prev_alpha = prev["alpha"];
+   const double lo = std::min(prev_alpha, alpha), hi = std::max(prev_alpha, alpha);
+   const int nb_rows = intervals.rows();
+
+   // rows with alpha.min in (lo, hi] and alpha.max >= hi (the column alpha.min is sorted)
+   std::vector<size_t> rows_min;
+   if(nb_rows > 0){
+      const double* alpha_min = &intervals(0,1);
+      for(int k = std::upper_bound(alpha_min, alpha_min+nb_rows, lo)-alpha_min; k<nb_rows && alpha_min[k]<=hi; k++)
+         if(hi <= intervals(k,2))
+            rows_min.push_back(intervals(k,0) - 1);
+   }
+   // rows with alpha.max in [lo, hi) and alpha.min <= lo
+   std::vector<size_t> rows_max;
+   auto max_less = [&](int k, double value){ return intervals(k-1,2) < value; };
+   for(auto it = std::lower_bound(max_order.begin(), max_order.end(), lo, max_less);
+       it != max_order.end() && intervals(*it-1,2) < hi; it++)
+      if(intervals(*it-1,1) <= lo)
+         rows_max.push_back(intervals(*it-1,0) - 1);
+   std::sort(rows_min.begin(), rows_min.end());
+   std::sort(rows_max.begin(), rows_max.end());
+
+   // sites with alpha-limit in [lo, hi), starting from 1
+   std::vector<size_t> sites;
+   auto limit_less = [&](int i, double value){ return alpha_limits[i-1] < value; };
+   for(auto it = std::lower_bound(limits_order.begin(), limits_order.end(), lo, limit_less);
+       it != limits_order.end() && alpha_limits[*it-1] < hi; it++)
+      sites.push_back(*it);
+   std::sort(sites.begin(), sites.end());
+
+   const Rcpp::IntegerVector& prev_rows = prev["rows"];
+   const Rcpp::IntegerVector& prev_extremes = prev["alpha.extremes"];
+   std::vector<size_t> rows(prev_rows.size()), alpha_extremes(prev_extremes.begin(), prev_extremes.end());
+   for(int i=0; i<prev_rows.size(); i++)
+      rows[i] = prev_rows[i] - 1;
+   if(prev_alpha < alpha){
+      rows = updateSorted(rows, rows_max, rows_min);
+      alpha_extremes = updateSorted(alpha_extremes, sites, std::vector<size_t>());
+   }
+   else{
+      rows = updateSorted(rows, rows_min, rows_max);
+      alpha_extremes = updateSorted(alpha_extremes, std::vector<size_t>(), sites);
+   }
+
+   return makeSpectrumAshape<real>(spectrum, rows, alpha, alpha_extremes);
+}
+
+// [[Rcpp::export(".ashapeUpdateRcpp")]]
+Rcpp::List ashapeUpdateRcpp(const Rcpp::List& prev, const double alpha) {
+   const Rcpp::List& spectrum = prev["spectrum"];
+   if(as_precision(Rcpp::as<std::string>(spectrum["precision"])) == Precision::Double)
+      return ashapeUpdateKernel<double>(prev, alpha);
+   return ashapeUpdateKernel<long double>(prev, alpha);
+}
@@ -6,94 +6,109 @@
 #include "newClasses/Segment.h"
 #include "newClasses/HalfPlane.h"
 #include "MyGAL/Vector2.h"
+#include "utilities.h"
+#include "delvor_handle.h"
 using namespace Rcpp;
 
-// [[Rcpp::export(".computeComplement")]]
-Rcpp::NumericMatrix computeComplement(const Rcpp::NumericMatrix& mesh, const long double& alpha){
-  typedef long double real;
-  
+/* Computes the complement of the alpha-hull as a union of open balls and open halfplanes and writes it in a
+ * new matrix with 19 columns (see computeComplementKernel)
+ * 
+ * real -> floating point representation to be used
+ * C -> type of the output (Rcpp::NumericMatrix or DoubleMatrix), it doesn't use the R API if it is a DoubleMatrix
+ * handle -> if not null, the native delvor object whose mesh is given, the distances are read from its cache
+ * 
+ * The edges are processed in blocks (see mesh_kernels.h): the distances are computed for the whole block,
+ * then each edge of the block is processed reading the columns of the mesh.
+ */
+template<typename real, typename C>
+C complementMatrix(const MeshColumns& mesh, const real& alpha, const DelvorHandle<real>* handle = nullptr){
   std::vector<Ball<real>> balls; // vector that contains the open balls that form the complement
   std::vector<HalfPlane<real>> halfplanes; // vector that contains the open halfplanes that form the complement
   std::vector<size_t> rows_balls; // vectors that contains the rows to which balls refer to
   std::vector<size_t> rows_halfplanes; // vectors that contains the rows to which halfplanes refer to
 
-  for(int i=0; i<mesh.rows(); i++){
-    Rcpp::checkUserInterrupt();
-
-    bool bp1 = (mesh(i,10) == 1), bp2 = (mesh(i,11) == 1);
-    // computing rects
-    Vector2<real>  p(mesh(i,2), mesh(i,3)); // 1st site
-    Vector2<real>  q(mesh(i,4), mesh(i,5)); // 2nd site
-    Vector2<real> e1(mesh(i,6), mesh(i,7)); // 1st extreme of the voronoi segment
-    Vector2<real> e2(mesh(i,8), mesh(i,9)); // 2nd extreme of the voronoi segment
-    Line<real> r(p,q), bis(e1,e2); // rect through p and q and bisectrix of p and q
-    Segment<real> vor_edge(e1,e2); // NB: infinite edge are clipped!! I will handle this later (*)
-    // eventual halfplanes to add or evaluate
-    HalfPlane<real> h1(r, r.eval(e1)==1? true: false ), // halfplane for bp1 = 1
-                    h2(r, r.eval(e2)==1? true: false ); // halfplane for bp2 = 1
-
-    // computing distances from p to endpoints of the voronoi edge (for infinite segments I use infinity)
-    real d1 = bp1? std::numeric_limits<real>::infinity(): p.getDistance(e1),
-         d2 = bp2? std::numeric_limits<real>::infinity(): p.getDistance(e2);
-
-    // searching extremes with distance alpha on the rect "bis"
-    std::vector<Vector2<real>> points = bis.getDistNeigh(p,alpha);
-
-    // add ball or halfplane for side of e1
-    if(bp1){ // if bp1 = 1 then I need to add an an halfplane
-      halfplanes.push_back(HalfPlane<real>(r, r.eval(e1)==1? true: false ));
-      rows_halfplanes.push_back(i);
-    }
-    else if(d1>=alpha){ // add a ball but only if e1 is at least distant alpha from p
-      balls.push_back(Ball<real>(e1,d1));
-      rows_balls.push_back(i);
+  real dist1[mesh_block_size], dist2[mesh_block_size];
+  for(size_t b=0; b<mesh.rows(); b+=mesh_block_size){
+    size_t e = std::min(mesh.rows(), b+mesh_block_size);
+    // distances from p to endpoints of the voronoi edges (for infinite segments I use infinity)
+    if(handle != nullptr){
+      std::copy(handle->dist1.begin()+b, handle->dist1.begin()+e, dist1);
+      std::copy(handle->dist2.begin()+b, handle->dist2.begin()+e, dist2);
     }
+    else
+      edgeDistances(mesh, b, e, dist1, dist2);
 
-    // add ball or halfplane for side of e2
-    if(!bp1 && bp2){ // if bp2 = 1 then I need to add an halfplane
-      halfplanes.push_back(HalfPlane<real>(r, r.eval(e2)==1? true: false ));
-      rows_halfplanes.push_back(i);
-    }
-    else if(d2>=alpha){ // add a ball but only if e2 is at least distant alpha from p
-      balls.push_back(Ball<real>(e2,d2));
-      rows_balls.push_back(i);
-    }
+    for(size_t i=b; i<e; i++){
+      bool bp1 = (mesh.bp1[i] == 1), bp2 = (mesh.bp2[i] == 1);
+      // computing rects
+      Vector2<real>  p(mesh.x1[i], mesh.y1[i]);   // 1st site
+      Vector2<real>  q(mesh.x2[i], mesh.y2[i]);   // 2nd site
+      Vector2<real> e1(mesh.mx1[i], mesh.my1[i]); // 1st extreme of the voronoi segment
+      Vector2<real> e2(mesh.mx2[i], mesh.my2[i]); // 2nd extreme of the voronoi segment
+      Line<real> r(p,q), bis(e1,e2); // rect through p and q and bisectrix of p and q
+      Segment<real> vor_edge(e1,e2); // NB: infinite edge are clipped!! I will handle this later (*)
+      // eventual halfplanes to add or evaluate
+      HalfPlane<real> h1(r, r.eval(e1)==1? true: false ), // halfplane for bp1 = 1
+                      h2(r, r.eval(e2)==1? true: false ); // halfplane for bp2 = 1
+
+      real d1 = dist1[i-b], d2 = dist2[i-b]; // distances from p to endpoints of the voronoi edge
+
+      // searching extremes with distance alpha on the rect "bis"
+      std::vector<Vector2<real>> points = bis.getDistNeigh(p,alpha);
+
+      // add ball or halfplane for side of e1
+      if(bp1){ // if bp1 = 1 then I need to add an an halfplane
+        halfplanes.push_back(HalfPlane<real>(r, r.eval(e1)==1? true: false ));
+        rows_halfplanes.push_back(i);
+      }
+      else if(d1>=alpha){ // add a ball but only if e1 is at least distant alpha from p
+        balls.push_back(Ball<real>(e1,d1));
+        rows_balls.push_back(i);
+      }
+
+      // add ball or halfplane for side of e2
+      if(!bp1 && bp2){ // if bp2 = 1 then I need to add an halfplane
+        halfplanes.push_back(HalfPlane<real>(r, r.eval(e2)==1? true: false ));
+        rows_halfplanes.push_back(i);
+      }
+      else if(d2>=alpha){ // add a ball but only if e2 is at least distant alpha from p
+        balls.push_back(Ball<real>(e2,d2));
+        rows_balls.push_back(i);
+      }
 
-    bool same_side1 = (h1.isIn(e1) == h1.isIn(e2)), // e1 and e2 are both in the upper (right) halfplane
-         same_side2 = (h2.isIn(e1) == h2.isIn(e2)); // e1 and e2 are both in the lower (left) halfplane
-    // add eventual ball for intersection points
-    for(size_t k=0; k<points.size(); k++){
-      bool add = false;
-      // if point[k] falls inside the Voronoi edge then for sure I need to add a ball (I don't use inside since, by
-      // construction the points and on the line bis, so by calling only inRange I avoid possibile numerical errors)
-      add = vor_edge.inRange(points[k]);
+      bool same_side1 = (h1.isIn(e1) == h1.isIn(e2)), // e1 and e2 are both in the upper (right) halfplane
+           same_side2 = (h2.isIn(e1) == h2.isIn(e2)); // e1 and e2 are both in the lower (left) halfplane
+      // add eventual ball for intersection points
+      for(size_t k=0; k<points.size(); k++){
+        bool add = false;
+        // if point[k] falls inside the Voronoi edge then for sure I need to add a ball (I don't use inside since, by
+        // construction the points and on the line bis, so by calling only inRange I avoid possibile numerical errors)
+        add = vor_edge.inRange(points[k]);
       
-      // (*) here I handle that problem
-      // if point[k] is not in the finite version of the Voronoi edge then I need to check whether orù
-      // not it belongs to an infinite edge
-      add = add || (bp1 && h1.isIn(points[k]) && (same_side1? alpha>=d2: true)); // checking if belongs to h1 (if bp1 = 1) AND distant at least alpha if the other edge estreme is in the same side
-      add = add || (bp2 && h2.isIn(points[k]) && (same_side2? alpha>=d1: true)); // checking if belongs to h2 (if bp2 = 1) AND distant at least alpha if the other edge estreme is in the same side
+        // (*) here I handle that problem
+        // if point[k] is not in the finite version of the Voronoi edge then I need to check whether orù
+        // not it belongs to an infinite edge
+        add = add || (bp1 && h1.isIn(points[k]) && (same_side1? alpha>=d2: true)); // checking if belongs to h1 (if bp1 = 1) AND distant at least alpha if the other edge estreme is in the same side
+        add = add || (bp2 && h2.isIn(points[k]) && (same_side2? alpha>=d1: true)); // checking if belongs to h2 (if bp2 = 1) AND distant at least alpha if the other edge estreme is in the same side
       
-      if(add){
-        balls.push_back(Ball<real>(points[k], p.getDistance(points[k])));
-        rows_balls.push_back(i);
+        if(add){
+          balls.push_back(Ball<real>(points[k], p.getDistance(points[k])));
+          rows_balls.push_back(i);
+        }
       }
     }
   }
 
   // constructing the output matrix
-  Rcpp::NumericMatrix complement(balls.size()+halfplanes.size(), 19);
+  C complement(balls.size()+halfplanes.size(), 19);
   for(size_t i=0; i<balls.size(); i++){
     size_t idx = rows_balls[i];
     complement(i,0) = balls[i].center().x; // c1
     complement(i,1) = balls[i].center().y; // c2
     complement(i,2) = balls[i].radius();   // r
-  
-    for(int j=0; j<mesh.cols(); j++) // mesh informations
-      complement(i,3+j) = mesh(idx,j);
     
     // retrieving the arc information
-    Vector2<real> p(mesh(idx,2), mesh(idx,3)), q(mesh(idx,4), mesh(idx,5));
+    Vector2<real> p(mesh.x1[idx], mesh.y1[idx]), q(mesh.x2[idx], mesh.y2[idx]);
     Vector2<real> pc = p - balls[i].center(), qc = q - balls[i].center();
     Vector2<real> v = (pc+qc);
     v = 1/v.getNorm()*v;
@@ -104,17 +119,72 @@ Rcpp::NumericMatrix computeComplement(const Rcpp::NumericMatrix& mesh, const lon
     complement(i,18) = theta;
   }
   for(size_t i=0; i<halfplanes.size(); i++){
-    size_t idx = rows_halfplanes[i];
     complement(balls.size()+i,0) = halfplanes[i].lineIntercept();
     complement(balls.size()+i,1) = halfplanes[i].lineSlope();
     complement(balls.size()+i,2) = (!halfplanes[i].isVertical()? -1: -3) - (halfplanes[i].getSide()==-1);
-    
-    for(int j=0; j<mesh.cols(); j++)
-      complement(balls.size()+i,3+j) = mesh(idx,j);
   }
-  colnames(complement) = Rcpp::CharacterVector::create("c1", "c2", "r", "ind1", "ind2", "x1", "y1", 
-                                                       "x2", "y2", "mx1", "my1", "mx2", "my2", "bp1", 
-                                                       "bp2", "ind", "v.x", "v.y", "theta");
+  // mesh informations, column by column
+  for(int j=0; j<mesh.cols(); j++){
+    for(size_t i=0; i<balls.size(); i++)
+      complement(i,3+j) = mesh(rows_balls[i],j);
+    for(size_t i=0; i<halfplanes.size(); i++)
+      complement(balls.size()+i,3+j) = mesh(rows_halfplanes[i],j);
+  }
+
+  return complement;
+}
+
+/* Computes the complement of the alpha-hull as a union of open balls and open halfplanes
+ * 
+ * real -> floating point representation to be used
+ */
+template<typename real>
+Rcpp::NumericMatrix computeComplementKernel(const Rcpp::NumericMatrix& mesh, const real& alpha){
+  Rcpp::checkUserInterrupt();
+  Rcpp::NumericMatrix complement = complementMatrix<real, Rcpp::NumericMatrix>(mesh_columns(mesh), alpha);
+  colnames(complement) = complement_colnames();
   
   return complement;
-};
+}
+
+template Rcpp::NumericMatrix computeComplementKernel<double>(const Rcpp::NumericMatrix&, const double&);
+template Rcpp::NumericMatrix computeComplementKernel<long double>(const Rcpp::NumericMatrix&, const long double&);
+
+// Same as computeComplementKernel without using the R API, so that it can be called from worker threads
+template<typename real>
+DoubleMatrix computeComplementBuffer(const MatrixView& mesh, const real& alpha){
+  return complementMatrix<real, DoubleMatrix>(mesh_columns(mesh), alpha);
+}
+
+template DoubleMatrix computeComplementBuffer<double>(const MatrixView&, const double&);
+template DoubleMatrix computeComplementBuffer<long double>(const MatrixView&, const long double&);
+
+// Same as computeComplementKernel for the mesh of a native delvor object, using its cached distances
+template<typename real>
+Rcpp::NumericMatrix computeComplementHandleKernel(const DelvorHandle<real>& handle, const real& alpha){
+  Rcpp::checkUserInterrupt();
+  Rcpp::NumericMatrix complement = complementMatrix<real, Rcpp::NumericMatrix>(mesh_columns(handle.mesh), alpha,
+                                                                                 &handle);
+  colnames(complement) = complement_colnames();
+
+  return complement;
+}
+
+template Rcpp::NumericMatrix computeComplementHandleKernel<double>(const DelvorHandle<double>&, const double&);
+template Rcpp::NumericMatrix computeComplementHandleKernel<long double>(const DelvorHandle<long double>&,
+                                                                        const long double&);
+
+// [[Rcpp::export(".computeComplementHandle")]]
+Rcpp::NumericMatrix computeComplementHandle(SEXP handle, const long double& alpha){
+  if(handle_precision(handle) == Precision::Double)
+    return computeComplementHandleKernel<double>(as_handle<double>(handle), alpha);
+  return computeComplementHandleKernel<long double>(as_handle<long double>(handle), alpha);
+}
+
+// [[Rcpp::export(".computeComplement")]]
+Rcpp::NumericMatrix computeComplement(const Rcpp::NumericMatrix& mesh, const long double& alpha,
+                                      const std::string precision = "long double"){
+  if(as_precision(precision) == Precision::Double)
+    return computeComplementKernel<double>(mesh, alpha);
+  return computeComplementKernel<long double>(mesh, alpha);
+}
@@ -0,0 +1,71 @@
+#ifndef _DELVOR_HANDLE_
+#define _DELVOR_HANDLE_
+
+// This header defines the native delvor object returned to R as an external pointer by delvor(handle = TRUE).
+// It keeps the edges of the tesselation in the same form as the mesh matrix of a delvor object (so that the
+// results computed from it are the same, bit by bit) together with the per-edge distances that the ashape and
+// complement kernels would otherwise compute again at every call.
+
+#include <Rcpp.h>
+#include <string>
+#include <vector>
+#include "utilities.h"
+
+/* real -> floating point representation used for the cached values, chosen when the handle is built; the
+ * kernels that read the cache use the same one
+ */
+template<typename real>
+struct DelvorHandle{
+  DoubleMatrix mesh;                                  // same content as the mesh of the delvor object
+  std::vector<double> x, y;                           // coordinates of the sites
+  std::vector<std::vector<std::size_t>> neighbours;   // Delaunay neighbours of each site, indices from 0
+
+  // distances from the first site of each edge to the extremes of its Voronoi edge, infinite for the extremes
+  // on the bounding box, and interval [alpha_min, alpha_max] of alpha of the edge (see edgeAlphaIntervals)
+  std::vector<real> dist1, dist2, alpha_min, alpha_max;
+  std::vector<real> alpha_limits;                     // alpha-limits of the sites (see computeAlphaLimits)
+
+  std::size_t nb_sites() const{ return x.size(); }
+};
+
+// defined and explicitly instantiated for double and long double in ashape_Rcpp.cpp
+template<typename real>
+void computeHandleCache(DelvorHandle<real>& handle, const int threads);
+
+/* The external pointer of a handle has the tag c("delvorhandle", precision), set when it is built: the
+ * precision of the handle is read from it and not from the attributes of the R object, which can be changed
+ */
+inline Rcpp::CharacterVector handle_tag(const std::string& precision){
+  return Rcpp::CharacterVector::create("delvorhandle", precision);
+}
+
+// precision of the native delvor object of an external pointer, error if it is not a delvor handle
+inline Precision handle_precision(SEXP handle){
+  if(TYPEOF(handle) != EXTPTRSXP || TYPEOF(R_ExternalPtrTag(handle)) != STRSXP)
+    Rcpp::stop("not a delvor handle, build it with delvor(handle = TRUE)");
+  Rcpp::CharacterVector tag(R_ExternalPtrTag(handle));
+  if(tag.size() != 2 || Rcpp::as<std::string>(tag[0]) != "delvorhandle")
+    Rcpp::stop("not a delvor handle, build it with delvor(handle = TRUE)");
+  return as_precision(Rcpp::as<std::string>(tag[1]));
+}
+
+// precision of the type real
+template<typename real>
+Precision precision_of();
+template<>
+inline Precision precision_of<double>(){ return Precision::Double; }
+template<>
+inline Precision precision_of<long double>(){ return Precision::LongDouble; }
+
+// native delvor object of an external pointer, which is null if the handle was saved and loaded again in R
+template<typename real>
+const DelvorHandle<real>& as_handle(SEXP handle){
+  if(handle_precision(handle) != precision_of<real>())
+    Rcpp::stop("the delvor handle was built with another precision");
+  Rcpp::XPtr<DelvorHandle<real>> ptr(handle);
+  if(ptr.get() == nullptr)
+    Rcpp::stop("the delvor handle is no longer valid (it was saved and restored), build it again with delvor");
+  return *ptr;
+}
+
+#endif
@@ -25,12 +25,10 @@ bool inahull_point(const Vector2<T>& point,
 }
 
 // This function evaluates whether or not the points (x and y coordinates) fall in the alpha hull denoted
-// by the the given complement matrix
-// [[Rcpp::export(".inahullRcpp")]]
-Rcpp::LogicalVector inahullRcpp(const Rcpp::NumericMatrix& complement, 
-                                const Rcpp::NumericVector& x, const Rcpp::NumericVector& y){
-  typedef long double real;
-  
+// by the the given complement matrix, real is the floating point representation to be used
+template<typename real>
+Rcpp::LogicalVector inahullKernel(const Rcpp::NumericMatrix& complement, 
+                                  const Rcpp::NumericVector& x, const Rcpp::NumericVector& y){
   std::vector<Ball<real>> balls;
   std::vector<HalfPlane<real>> halfplanes;
   
@@ -42,4 +40,18 @@ Rcpp::LogicalVector inahullRcpp(const Rcpp::NumericMatrix& complement,
     res[i] = inahull_point<real>(Vector2<real>(x[i], y[i]), balls, halfplanes)? 1: 0;
   
   return res;
-}
\ No newline at end of file
+}
+
+template Rcpp::LogicalVector inahullKernel<double>(const Rcpp::NumericMatrix&, const Rcpp::NumericVector&,
+                                                   const Rcpp::NumericVector&);
+template Rcpp::LogicalVector inahullKernel<long double>(const Rcpp::NumericMatrix&, const Rcpp::NumericVector&,
+                                                        const Rcpp::NumericVector&);
+
+// [[Rcpp::export(".inahullRcpp")]]
+Rcpp::LogicalVector inahullRcpp(const Rcpp::NumericMatrix& complement, 
+                                const Rcpp::NumericVector& x, const Rcpp::NumericVector& y,
+                                const std::string precision = "long double"){
+  if(as_precision(precision) == Precision::Double)
+    return inahullKernel<double>(complement, x, y);
+  return inahullKernel<long double>(complement, x, y);
+}
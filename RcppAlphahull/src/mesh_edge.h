@@ -0,0 +1,48 @@
+#ifndef _MESH_EDGE_
+#define _MESH_EDGE_
+
+// This header defines the rows of the mesh matrix of a delvor object as they are read from a diagram built by
+// the Fortune's algorithm. Nothing here calls the R API, so it is shared by the sequential and the parallel
+// construction (see parallel_delvor.h) and by the checks in test_scripts.
+
+#include <cstddef>
+#include <utility>
+#include "MyGAL/FortuneAlgorithm.h"
+using namespace mygal;
+
+// One row of the mesh matrix of a delvor object, sites indices start from 0
+template<typename T>
+struct MeshEdge{
+  std::size_t ind1, ind2; // sites on the two sides of the edge
+  Vector2<T> e1, e2;      // extremes of the Voronoi edge
+  bool bp1, bp2;          // the extreme lies on the bounding box (the edge is infinite)
+};
+
+/* Calls f(k, edge) for the edges k in [begin, end) of a bounded diagram, i.e. the pairs of twin half-edges in
+ * the order in which they were created by the Fortune's algorithm (the half-edges added by the bounding are not
+ * edges). The extremes on the bounding box are the vertices flagged by the bounding, no coordinate is compared.
+ * Each call only reads the diagram, so disjoint ranges can be visited by different threads.
+ */
+template<typename T, typename F>
+void for_each_mesh_edge(const Diagram<T>& diagram, F&& f, std::size_t begin, std::size_t end){
+  const auto& edges = diagram.getEdges();
+  for(std::size_t k=begin; k<end; k++){
+    const auto* he = edges[k].leftHalfEdge;
+    MeshEdge<T> edge;
+    edge.ind1 = he->incidentFace->site->index;
+    edge.ind2 = he->twin->incidentFace->site->index;
+    edge.e1 = he->destination->point;
+    edge.e2 = he->origin->point;
+    edge.bp1 = he->destination->onFrontier;
+    edge.bp2 = he->origin->onFrontier;
+    f(k, edge);
+  }
+}
+
+// Calls f(k, edge) for all the edges of a bounded diagram
+template<typename T, typename F>
+void for_each_mesh_edge(const Diagram<T>& diagram, F&& f){
+  for_each_mesh_edge(diagram, std::forward<F>(f), 0, diagram.getNbEdges());
+}
+
+#endif
@@ -0,0 +1,347 @@
+#ifndef _MESH_KERNELS_
+#define _MESH_KERNELS_
+
+// This header defines the per-edge kernels that traverse the mesh matrix of a delvor object (see delvor.R
+// for its columns). The matrix is stored by columns, as R does: reading it row by row touches, for each
+// edge, 12 values far apart from each other. The kernels instead read the columns they need as contiguous
+// arrays and work on blocks of edges: each quantity is computed for the whole block by a simple loop over
+// the columns, then the branchy part (segment intersection, selection of the edges) only runs on the edges
+// of the block that need it while they are still in cache.
+//
+// The values are computed with the same operations, in the same order, as Vector2::getDistance, so the
+// results are the same, bit by bit, as the row by row code. For double the distances and the segment
+// intersections are computed 4 edges at once with AVX2 when the processor supports it (see mesh_simd.h),
+// with the same results.
+//
+// The kernels that take a number of threads split the edges in chunks processed by parallel_for (see
+// parallel.h); their results don't depend on the number of threads.
+//
+// Nothing here calls the R API, so the kernels can be run by worker threads and by the benchmarks in
+// test_scripts.
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <vector>
+#include "MyGAL/Vector2.h"
+#include "newClasses/Segment.h"
+#include "mesh_simd.h"
+#include "parallel.h"
+
+// number of edges processed at once, the block of each column stays in the L1 cache
+const std::size_t mesh_block_size = 256;
+
+// minimum number of edges handed to a thread by the parallel kernels, below it threads cost more than they save
+const std::size_t min_edges_per_chunk = 1 << 16;
+
+// number of chunks in which n edges are split to be processed on the given number of threads
+inline std::size_t nb_edge_chunks(std::size_t n, int threads){
+  return std::max<std::size_t>(1, std::min<std::size_t>(std::max(threads, 1), n/min_edges_per_chunk));
+}
+
+// Columns of a mesh matrix stored by columns (data points to its first element)
+struct MeshColumns{
+  const double *ind1, *ind2, *x1, *y1, *x2, *y2, *mx1, *my1, *mx2, *my2, *bp1, *bp2;
+  std::size_t nrow;
+
+  MeshColumns(const double* data, std::size_t nrow):
+    ind1(data), ind2(data+nrow), x1(data+2*nrow), y1(data+3*nrow), x2(data+4*nrow), y2(data+5*nrow),
+    mx1(data+6*nrow), my1(data+7*nrow), mx2(data+8*nrow), my2(data+9*nrow), bp1(data+10*nrow),
+    bp2(data+11*nrow), nrow(nrow) {}
+  double operator()(std::size_t i, int j) const{ return ind1[i+j*nrow]; }
+  std::size_t rows() const{ return nrow; }
+  int cols() const{ return 12; }
+};
+
+/* dist[k] = distance between (x1[k], y1[k]) and (x2[k], y2[k]) for k in [0, n), infinite where bp[k] == 1 if bp
+ * is not null
+ */
+template<typename T>
+void pointDistances(const double* x1, const double* y1, const double* x2, const double* y2, const double* bp,
+                    std::size_t n, T* dist){
+  const T inf = std::numeric_limits<T>::infinity();
+  for(std::size_t k=0; k<n; k++){
+    T dx = T(x1[k])-T(x2[k]), dy = T(y1[k])-T(y2[k]);
+    T d = std::sqrt(dx*dx+dy*dy);
+    dist[k] = bp != nullptr && bp[k] == 1? inf: d;
+  }
+}
+
+// same as above for double, with the AVX2 kernel if available (see mesh_simd.h)
+inline void pointDistances(const double* x1, const double* y1, const double* x2, const double* y2,
+                           const double* bp, std::size_t n, double* dist){
+#ifdef MESH_SIMD_AVX2
+  if(simd::enabled()){
+    simd::distances(x1, y1, x2, y2, bp, n, dist);
+    return;
+  }
+#endif
+  pointDistances<double>(x1, y1, x2, y2, bp, n, dist);
+}
+
+/* Distances, for the edges in [begin, end), from the first site to the extremes of the Voronoi edge (dist1
+ * and dist2, infinite for the extremes on the bounding box) and to the second site (dist3, if not null).
+ * The k-th value of each output refers to the edge begin+k.
+ */
+template<typename T>
+void edgeDistances(const MeshColumns& mesh, std::size_t begin, std::size_t end, T* dist1, T* dist2,
+                   T* dist3 = nullptr){
+  const std::size_t n = end-begin;
+  const double *x1 = mesh.x1+begin, *y1 = mesh.y1+begin;
+  pointDistances(x1, y1, mesh.mx1+begin, mesh.my1+begin, mesh.bp1+begin, n, dist1);
+  pointDistances(x1, y1, mesh.mx2+begin, mesh.my2+begin, mesh.bp2+begin, n, dist2);
+  if(dist3 != nullptr)
+    pointDistances(x1, y1, mesh.x2+begin, mesh.y2+begin, nullptr, n, dist3);
+}
+
+// whether the segment between the sites of the i-th edge crosses its Voronoi edge
+template<typename T>
+bool edgeCrossesVoronoi(const MeshColumns& mesh, std::size_t i){
+  Segment<T> s1(Vector2<T>(mesh.x1[i], mesh.y1[i]), Vector2<T>(mesh.x2[i], mesh.y2[i]));
+  Segment<T> s2(Vector2<T>(mesh.mx1[i], mesh.my1[i]), Vector2<T>(mesh.mx2[i], mesh.my2[i]));
+  return s1.intersect(s2);
+}
+
+/* crosses[k] = edgeCrossesVoronoi<T>(mesh, begin+k) for the edges in [begin, end); for double the AVX2 kernel
+ * decides 4 edges at once, the scalar test is only done for the ones it cannot decide (see mesh_simd.h)
+ */
+template<typename T>
+void edgeCrossings(const MeshColumns& mesh, std::size_t begin, std::size_t end, bool* crosses){
+#ifdef MESH_SIMD_AVX2
+  if(std::is_same<T, double>::value && simd::enabled()){
+    signed char batch[mesh_block_size];
+    for(std::size_t b=begin; b<end; b+=mesh_block_size){
+      std::size_t e = std::min(end, b+mesh_block_size);
+      simd::crossings(mesh.x1+b, mesh.y1+b, mesh.x2+b, mesh.y2+b, mesh.mx1+b, mesh.my1+b, mesh.mx2+b, mesh.my2+b,
+                      e-b, batch);
+      for(std::size_t k=0; k<e-b; k++)
+        crosses[b-begin+k] = batch[k] == -1? edgeCrossesVoronoi<T>(mesh, b+k): batch[k] == 1;
+    }
+    return;
+  }
+#endif
+  for(std::size_t i=begin; i<end; i++)
+    crosses[i-begin] = edgeCrossesVoronoi<T>(mesh, i);
+}
+
+/* Computes, for the edges in [begin, end), the interval [alpha_min, alpha_max] of the values of alpha for
+ * which the edge of the Delaunay triangulation belongs to the alpha-shape (provided that its two sites are
+ * alpha-extremes) and, if not null, the distances dist1 and dist2 (see edgeDistances). The outputs are
+ * indexed by the edge (the k-th value refers to the edge k).
+ */
+template<typename T>
+void edgeAlphaIntervals(const MeshColumns& mesh, std::size_t begin, std::size_t end, T* alpha_min, T* alpha_max,
+                        T* dist1 = nullptr, T* dist2 = nullptr, int threads = 1){
+  const std::size_t n = end-begin, nb_chunks = nb_edge_chunks(n, threads);
+  if(nb_chunks > 1){
+    parallel_for(nb_chunks, threads, [&](std::size_t c){
+      edgeAlphaIntervals(mesh, begin+c*n/nb_chunks, begin+(c+1)*n/nb_chunks, alpha_min, alpha_max, dist1, dist2);
+    });
+    return;
+  }
+
+  T d1[mesh_block_size], d2[mesh_block_size], d3[mesh_block_size];
+  bool crosses[mesh_block_size];
+  for(std::size_t b=begin; b<end; b+=mesh_block_size){
+    std::size_t e = std::min(end, b+mesh_block_size);
+    edgeDistances(mesh, b, e, d1, d2, d3);
+    edgeCrossings<T>(mesh, b, e, crosses);
+    for(std::size_t k=0; k<e-b; k++){
+      alpha_min[b+k] = crosses[k]? d3[k]/2: std::min(d1[k], d2[k]);
+      alpha_max[b+k] = std::max(d1[k], d2[k]);
+    }
+    if(dist1 != nullptr)
+      std::copy(d1, d1+(e-b), dist1+b);
+    if(dist2 != nullptr)
+      std::copy(d2, d2+(e-b), dist2+b);
+  }
+}
+
+/* Returns the alpha-limits of the nb_sites sites: one can show that for each site of the diagram it holds
+ * p=(x;y) alpha-extreme for any alpha <= alpha^i_L
+ * alpha^i_L = max( dist(p,v), v vertex of face of point p in the voronoi diagram )
+ * i.e. the largest distance from the site to the extremes of its Voronoi edges, infinite if one of them is
+ * infinite.
+ *
+ * Each chunk of edges computes the maxima of its own edges, which are then merged site by site: the maximum
+ * is exact, so the result is the same for any number of threads.
+ */
+template<typename T>
+std::vector<T> alphaLimits(const MeshColumns& mesh, std::size_t nb_sites, int threads = 1){
+  const std::size_t n = mesh.rows(), nb_chunks = nb_edge_chunks(n, threads);
+  std::vector<std::vector<T>> partial(nb_chunks);
+  parallel_for(nb_chunks, threads, [&](std::size_t c){
+    std::vector<T>& alpha_L = partial[c];
+    alpha_L.assign(nb_sites, 0);
+    T d1[mesh_block_size], d2[mesh_block_size];
+    for(std::size_t b=c*n/nb_chunks; b<(c+1)*n/nb_chunks; b+=mesh_block_size){
+      std::size_t e = std::min((c+1)*n/nb_chunks, b+mesh_block_size);
+      edgeDistances(mesh, b, e, d1, d2);
+      for(std::size_t k=0; k<e-b; k++){
+        T d = std::max(d1[k], d2[k]);
+        T& limit1 = alpha_L[mesh.ind1[b+k]-1];
+        T& limit2 = alpha_L[mesh.ind2[b+k]-1];
+        limit1 = std::max(limit1, d);
+        limit2 = std::max(limit2, d);
+      }
+    }
+  });
+
+  std::vector<T> alpha_L = std::move(partial[0]);
+  parallel_for(nb_chunks, threads, [&](std::size_t c){
+    for(std::size_t i=c*nb_sites/nb_chunks; i<(c+1)*nb_sites/nb_chunks; i++)
+      for(std::size_t p=1; p<nb_chunks; p++)
+        alpha_L[i] = std::max(alpha_L[i], partial[p][i]);
+  });
+  return alpha_L;
+}
+
+/* Selects the alpha-extremes for the given value of alpha from the alpha-limits of the sites (see alphaLimits):
+ * appends their indices (starting from 1) to alpha_extremes and returns a flag for each site.
+ */
+template<typename T>
+std::vector<bool> alphaExtremes(const std::vector<T>& alpha_limits, const T& alpha,
+                                std::vector<std::size_t>& alpha_extremes){
+  std::vector<bool> is_alpha_extreme(alpha_limits.size(), false);
+  for(std::size_t i=0; i<alpha_limits.size(); i++)
+    if(alpha <= alpha_limits[i]){
+      alpha_extremes.push_back(i+1);
+      is_alpha_extreme[i] = true;
+    }
+  return is_alpha_extreme;
+}
+
+/* Whether edge i belongs to the alpha-shape for the given value of alpha: its sites are alpha-extremes
+ * (is_alpha_extreme, indices starting from 0) and its interval [alpha_min, alpha_max] contains alpha (see
+ * edgeAlphaIntervals). alpha_min() is only called when the other conditions hold, so that it can be computed
+ * lazily. All the selections of the edges of an alpha-shape go through this test.
+ */
+template<typename T, typename A>
+bool isAlphaShapeEdge(const MeshColumns& mesh, std::size_t i, const std::vector<bool>& is_alpha_extreme,
+                      const T& alpha, const T& alpha_max, A alpha_min){
+  return is_alpha_extreme[mesh.ind1[i]-1] && is_alpha_extreme[mesh.ind2[i]-1] && alpha <= alpha_max &&
+         alpha_min() <= alpha;
+}
+
+/* Calls f(i, d) for each edge i in [begin, end) of the alpha-shape for the given value of alpha, in
+ * increasing order of i, d being the distance between its sites (see isAlphaShapeEdge). The segment
+ * intersection that decides alpha_min is only tested when alpha lies between its two possible values,
+ * otherwise both give the same result.
+ */
+template<typename T, typename F>
+void forEachAlphaShapeEdge(const MeshColumns& mesh, std::size_t begin, std::size_t end,
+                           const std::vector<bool>& is_alpha_extreme, const T& alpha, F f){
+  T d1[mesh_block_size], d2[mesh_block_size], d3[mesh_block_size];
+  for(std::size_t b=begin; b<end; b+=mesh_block_size){
+    std::size_t e = std::min(end, b+mesh_block_size);
+    edgeDistances(mesh, b, e, d1, d2, d3);
+    for(std::size_t k=0; k<e-b; k++){
+      std::size_t i = b+k;
+      auto alpha_min = [&](){
+        bool half = d3[k]/2 <= alpha, nearest = std::min(d1[k], d2[k]) <= alpha;
+        return half == nearest || edgeCrossesVoronoi<T>(mesh, i)? d3[k]/2: std::min(d1[k], d2[k]);
+      };
+      if(isAlphaShapeEdge(mesh, i, is_alpha_extreme, alpha, std::max(d1[k], d2[k]), alpha_min))
+        f(i, d3[k]);
+    }
+  }
+}
+
+/* Same as above with the intervals of the edges already computed (see edgeAlphaIntervals, indexed by the
+ * edge), calls f(i) for each edge i of the alpha-shape
+ */
+template<typename T, typename F>
+void forEachAlphaShapeEdge(const MeshColumns& mesh, std::size_t begin, std::size_t end,
+                           const std::vector<bool>& is_alpha_extreme, const T& alpha, const T* alpha_min,
+                           const T* alpha_max, F f){
+  for(std::size_t i=begin; i<end; i++)
+    if(isAlphaShapeEdge(mesh, i, is_alpha_extreme, alpha, alpha_max[i], [&](){ return alpha_min[i]; }))
+      f(i);
+}
+
+/* Returns the edges of the alpha-shape for the given value of alpha (see forEachAlphaShapeEdge). Each chunk
+ * of edges collects its own rows, which are concatenated in the order of the chunks.
+ */
+template<typename T>
+std::vector<std::size_t> alphaShapeEdges(const MeshColumns& mesh, const std::vector<bool>& is_alpha_extreme,
+                                         const T& alpha, int threads = 1){
+  const std::size_t n = mesh.rows(), nb_chunks = nb_edge_chunks(n, threads);
+  std::vector<std::vector<std::size_t>> rows(nb_chunks);
+  parallel_for(nb_chunks, threads, [&](std::size_t c){
+    forEachAlphaShapeEdge(mesh, c*n/nb_chunks, (c+1)*n/nb_chunks, is_alpha_extreme, alpha,
+                          [&](std::size_t i, const T&){ rows[c].push_back(i); });
+  });
+
+  std::vector<std::size_t> which_rows = std::move(rows[0]);
+  for(std::size_t c=1; c<nb_chunks; c++)
+    which_rows.insert(which_rows.end(), rows[c].begin(), rows[c].end());
+  return which_rows;
+}
+
+// Set of edges of a mesh stored as a bit mask, one bit for each edge
+struct EdgeMask{
+  std::vector<unsigned long long> words;
+  std::size_t count = 0;
+
+  explicit EdgeMask(std::size_t nrow): words((nrow+63)/64, 0) {}
+  void insert(std::size_t i){
+    words[i/64] |= 1ULL << (i%64);
+    count++;
+  }
+  // calls f(i) for each edge i of the set, in increasing order
+  template<typename F>
+  void for_each(F f) const{
+    for(std::size_t w=0; w<words.size(); w++)
+      for(unsigned long long bits = words[w]; bits != 0; bits &= bits-1){
+#if defined(__GNUC__) || defined(__clang__)
+        int b = __builtin_ctzll(bits);
+#else
+        int b = 0;
+        while(!(bits >> b & 1))
+          b++;
+#endif
+        f(64*w+b);
+      }
+  }
+};
+
+/* Selects the edges of the alpha-shape for the given value of alpha (see forEachAlphaShapeEdge) and returns
+ * its length in the same pass: the distances between the sites are the ones computed for the selection and
+ * are summed in the order of the edges, as alphaShapeLength does.
+ */
+template<typename T>
+T alphaShapeSelect(const MeshColumns& mesh, const std::vector<bool>& is_alpha_extreme, const T& alpha,
+                   EdgeMask& selected){
+  T length = 0;
+  forEachAlphaShapeEdge(mesh, 0, mesh.rows(), is_alpha_extreme, alpha, [&](std::size_t i, const T& d){
+    selected.insert(i);
+    length += d;
+  });
+  return length;
+}
+
+/* Writes the rows of the mesh in selected, in increasing order, to the matrix of selected.count rows stored by
+ * columns that edges points to
+ */
+inline void copyEdges(const MeshColumns& mesh, const EdgeMask& selected, double* edges){
+  for(int j=0; j<mesh.cols(); j++){
+    const double* column = mesh.ind1+j*mesh.rows();
+    double* out = edges+j*selected.count;
+    selected.for_each([&](std::size_t i){ *out++ = column[i]; });
+  }
+}
+
+// Length of the alpha-shape, i.e. the sum of the distances between the sites of its edges
+template<typename T>
+T alphaShapeLength(const MeshColumns& edges){
+  T length = 0;
+  for(std::size_t i=0; i<edges.rows(); i++){
+    T dx = T(edges.x1[i])-T(edges.x2[i]), dy = T(edges.y1[i])-T(edges.y2[i]);
+    length += std::sqrt(dx*dx+dy*dy);
+  }
+  return length;
+}
+
+#endif
@@ -0,0 +1,132 @@
+#ifndef _MESH_SIMD_
+#define _MESH_SIMD_
+
+// This header defines the AVX2 versions of the per-edge kernels of mesh_kernels.h for double, which process
+// 4 edges at once. They are compiled for AVX2 through the target attribute and only called if the processor
+// supports it (see simd::enabled), so the package is still built with the default flags of R; on other
+// compilers/architectures, if RCPPALPHAHULL_NO_SIMD is defined or if the code is built with FMA enabled
+// (e.g. -march=native, the compiler would then contract the scalar and the vector operations differently),
+// only the scalar kernels are available.
+//
+// The results are the same, bit by bit, as the scalar kernels for double: the lanes do the same IEEE
+// operations in the same order (with no fused multiply-add) and the segment intersection only uses the
+// floating point filter of the orientation predicate, the lanes for which it is not enough are marked and
+// left to the scalar code (see crossings).
+//
+// Nothing here calls the R API.
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include "MyGAL/Predicates.h"
+
+#if !defined(RCPPALPHAHULL_NO_SIMD) && !defined(__FMA__) && (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__))
+#define MESH_SIMD_AVX2
+#include <immintrin.h>
+#endif
+
+namespace simd{
+
+// whether the AVX2 kernels are used, it can be set to false to force the scalar kernels
+inline bool& enabled(){
+#ifdef MESH_SIMD_AVX2
+  static bool use = __builtin_cpu_supports("avx2");
+#else
+  static bool use = false;
+#endif
+  return use;
+}
+
+#ifdef MESH_SIMD_AVX2
+
+// sign masks (pos, neg) of orientation(a, b, c) for 4 lanes; certain is false for the lanes in which the
+// floating point filter of mygal::orientation is not enough to know the sign
+__attribute__((target("avx2")))
+inline void orientation4(__m256d ax, __m256d ay, __m256d bx, __m256d by, __m256d cx, __m256d cy,
+                         __m256d& pos, __m256d& neg, __m256d& certain){
+  const __m256d zero = _mm256_setzero_pd(), sign_bit = _mm256_set1_pd(-0.0);
+  const __m256d bound_factor = _mm256_set1_pd(mygal::expansion::Constants<double>::orientationBound);
+  __m256d det_left = _mm256_mul_pd(_mm256_sub_pd(ax, cx), _mm256_sub_pd(by, cy));
+  __m256d det_right = _mm256_mul_pd(_mm256_sub_pd(ay, cy), _mm256_sub_pd(bx, cx));
+  __m256d det = _mm256_sub_pd(det_left, det_right);
+  __m256d det_sum = _mm256_add_pd(_mm256_andnot_pd(sign_bit, det_left), _mm256_andnot_pd(sign_bit, det_right));
+  __m256d bound = _mm256_mul_pd(bound_factor, det_sum);
+  // no cancellation if the two products have different signs
+  __m256d no_cancel = _mm256_or_pd(
+    _mm256_or_pd(_mm256_and_pd(_mm256_cmp_pd(det_left, zero, _CMP_GT_OQ), _mm256_cmp_pd(det_right, zero, _CMP_LE_OQ)),
+                 _mm256_and_pd(_mm256_cmp_pd(det_left, zero, _CMP_LT_OQ), _mm256_cmp_pd(det_right, zero, _CMP_GE_OQ))),
+    _mm256_cmp_pd(det_left, zero, _CMP_EQ_OQ));
+  __m256d above_bound = _mm256_or_pd(_mm256_cmp_pd(det, bound, _CMP_GE_OQ),
+                                     _mm256_cmp_pd(_mm256_xor_pd(det, sign_bit), bound, _CMP_GE_OQ));
+  certain = _mm256_or_pd(no_cancel, above_bound);
+  pos = _mm256_cmp_pd(det, zero, _CMP_GT_OQ);
+  neg = _mm256_cmp_pd(det, zero, _CMP_LT_OQ);
+}
+
+/* dist[k] = distance between (x1[k], y1[k]) and (x2[k], y2[k]) for k in [0, n), infinite where bp[k] == 1 if bp
+ * is not null
+ */
+__attribute__((target("avx2")))
+inline void distances(const double* x1, const double* y1, const double* x2, const double* y2, const double* bp,
+                      std::size_t n, double* dist){
+  const __m256d one = _mm256_set1_pd(1), inf = _mm256_set1_pd(std::numeric_limits<double>::infinity());
+  std::size_t k = 0;
+  for(; k+4<=n; k+=4){
+    __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(x1+k), _mm256_loadu_pd(x2+k));
+    __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(y1+k), _mm256_loadu_pd(y2+k));
+    __m256d d = _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy)));
+    if(bp != nullptr)
+      d = _mm256_blendv_pd(d, inf, _mm256_cmp_pd(_mm256_loadu_pd(bp+k), one, _CMP_EQ_OQ));
+    _mm256_storeu_pd(dist+k, d);
+  }
+  for(; k<n; k++){
+    double dx = x1[k]-x2[k], dy = y1[k]-y2[k];
+    double d = std::sqrt(dx*dx+dy*dy);
+    dist[k] = bp != nullptr && bp[k] == 1? std::numeric_limits<double>::infinity(): d;
+  }
+}
+
+/* For k in [0, n), whether the segment from (x1[k], y1[k]) to (x2[k], y2[k]) crosses the one from (mx1[k], my1[k])
+ * to (mx2[k], my2[k]) as Segment::intersect decides it: crosses[k] is 1 or 0, or -1 if the floating point filter
+ * is not enough or the segments are collinear, in which case the scalar test has to be done. The lanes of the
+ * last incomplete group are always -1.
+ */
+__attribute__((target("avx2")))
+inline void crossings(const double* x1, const double* y1, const double* x2, const double* y2, const double* mx1,
+                      const double* my1, const double* mx2, const double* my2, std::size_t n, signed char* crosses){
+  std::size_t k = 0;
+  for(; k+4<=n; k+=4){
+    __m256d px = _mm256_loadu_pd(x1+k), py = _mm256_loadu_pd(y1+k), qx = _mm256_loadu_pd(x2+k),
+            qy = _mm256_loadu_pd(y2+k), e1x = _mm256_loadu_pd(mx1+k), e1y = _mm256_loadu_pd(my1+k),
+            e2x = _mm256_loadu_pd(mx2+k), e2y = _mm256_loadu_pd(my2+k);
+    __m256d pos1, neg1, c1, pos2, neg2, c2, pos3, neg3, c3, pos4, neg4, c4;
+    orientation4(px, py, qx, qy, e1x, e1y, pos1, neg1, c1);
+    orientation4(px, py, qx, qy, e2x, e2y, pos2, neg2, c2);
+    orientation4(e1x, e1y, e2x, e2y, px, py, pos3, neg3, c3);
+    orientation4(e1x, e1y, e2x, e2y, qx, qy, pos4, neg4, c4);
+    __m256d certain = _mm256_and_pd(_mm256_and_pd(c1, c2), _mm256_and_pd(c3, c4));
+    __m256d cross = _mm256_and_pd(_mm256_or_pd(_mm256_xor_pd(pos1, pos2), _mm256_xor_pd(neg1, neg2)),
+                                  _mm256_or_pd(_mm256_xor_pd(pos3, pos4), _mm256_xor_pd(neg3, neg4)));
+    __m256d collinear = _mm256_andnot_pd(_mm256_or_pd(_mm256_or_pd(pos1, neg1), _mm256_or_pd(pos2, neg2)),
+                                         _mm256_castsi256_pd(_mm256_set1_epi64x(-1)));
+    int certain_bits = _mm256_movemask_pd(certain), cross_bits = _mm256_movemask_pd(cross),
+        collinear_bits = _mm256_movemask_pd(collinear);
+    for(int l=0; l<4; l++){
+      if(!(certain_bits >> l & 1))
+        crosses[k+l] = -1;
+      else if(cross_bits >> l & 1)
+        crosses[k+l] = 1;
+      else
+        crosses[k+l] = (collinear_bits >> l & 1)? -1: 0;
+    }
+  }
+  for(; k<n; k++)
+    crosses[k] = -1;
+}
+
+#endif
+
+} // namespace simd
+
+#endif
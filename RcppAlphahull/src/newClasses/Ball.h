@@ -76,18 +76,27 @@ class Ball: public AreaObj<T>{
     
     // Computes intersection points between two balls with different centers
     std::vector<vector> intersections(const Ball<T>& b) const{
+      vector p1, p2;
       std::vector<vector> intersections;
-      intersections.reserve(2);
-      
+      size_t n = intersections(b, p1, p2);
+      if( n>0 )
+        intersections.push_back(p1);
+      if( n>1 )
+        intersections.push_back(p2);
+      return intersections;
+    }
+    
+    // Same as above without allocating: stores the intersection points in p1 and p2 and returns their number
+    size_t intersections(const Ball<T>& b, vector& p1, vector& p2) const{
       // maybe throw an error if a ball with the same center ios provided
       if( c == b.c ){
         std::cerr << "Intersection of concentric balls detected" << std::endl;
-        return intersections;
+        return 0;
       }
 
       T d = c.getDistance(b.c);
       if( d>r+b.r || d < std::fabs(r-b.r))
-        return intersections;
+        return 0;
 
       T a = (d+(r*r-b.r*b.r)/d)/2, // b = d-a, // b results unused
         h=std::sqrt(r*r-a*a);
@@ -95,27 +104,23 @@ class Ball: public AreaObj<T>{
       vector v = b.c-c,
              v_norm = v.getOrthogonal();
       // retrieving the dummy point on the segment between the two balls' centers
-      vector p1 = c + a/d*(b.c-c); // point distant a from c1 on the segment (c1)
+      vector p = c + a/d*(b.c-c); // point distant a from c1 on the segment (c1)
       // computing the two intersections
-      vector p2_1 = p1 - h/d*v_norm,
-             p2_2 = p1 + h/d*v_norm ;
-
-      intersections.push_back(p2_1);
-      if( h > 0 )
-        intersections.push_back(p2_2);
+      p1 = p - h/d*v_norm;
+      p2 = p + h/d*v_norm;
       
-      return intersections;
+      return h > 0? 2: 1;
     }
     
     // Computes the intersection arc (on the caller circumference) between two balls with different centers
     arc intersection_arc(const Ball<T>& b) const{
-      std::vector<vector> points = intersections(b);
+      vector p1, p2;
       
-      if(points.size()<2) // if the balls are concentric, share just one point or are disconnected then there's no arc
+      if(intersections(b, p1, p2)<2) // if the balls are concentric, share just one point or are disconnected then there's no arc
         return arc(*this,1,0,0); // returning a null arc
       
       // if there are two intersection points then i can define an arc
-      return arc(*this, points[0]-c, angle_vects<T>(points[0]-c,points[1]-c));
+      return arc(*this, p1-c, angle_vects<T>(p1-c,p2-c));
     }
 };
 
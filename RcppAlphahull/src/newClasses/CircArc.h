@@ -80,8 +80,10 @@ class CircArc{
     };
     
     // Returns the angle of end point direction of the arc (value in (0;2*PI])
-    T theta2() const { 
-      T theta2 = theta1()+alpha;
+    T theta2() const { return theta2(theta1()); };
+    // Same as above, given the angle of v (avoids computing it again)
+    T theta2(const T& t1) const { 
+      T theta2 = t1+alpha;
       theta2-= theta2>2*M_PI? 2*M_PI: 0;
       return theta2;
     };
@@ -89,83 +91,126 @@ class CircArc{
     // OTHER METHODS
     // Returns an arc rotated (counter-clockwise) by the angle theta
     CircArc<T> rotate_arc(const T& theta) const { return CircArc<T>(b, rotate<T>(v,theta), alpha); }
+    // Returns an arc rotated (counter-clockwise) by the angle whose cosine and sine are given
+    CircArc<T> rotate_arc(const T& cos_theta, const T& sin_theta) const { 
+      return CircArc<T>(b, rotate<T>(v,cos_theta,sin_theta), alpha); 
+    }
     
     // Computes the set difference between two arcs on the same circumference
-    std::vector<CircArc> diff(const CircArc& a2) const{// arcs not on the same circumference
-      if( b != a2.b ){
+    std::vector<CircArc> diff(const CircArc& a2) const{
+      std::vector<CircArc> res;
+      diff(a2, res);
+      return res;
+    };
+    
+    // Same as above, appending the resulting arcs to res. The angles of the arcs and the cosine and sine of
+    // the rotations are computed once.
+    void diff(const CircArc& a2, std::vector<CircArc>& res) const{
+      if( b != a2.b ){ // arcs not on the same circumference
         std::cerr << "Error! arc difference with arcs in differet circles" << std::endl;
-        return std::vector<CircArc>{*this};
+        res.push_back(*this);
+        return;
       }
       
       // second arc is the whole circumference (the whole arc is removed)
       if(a2.alpha == 2*M_PI ) // I have to remove a whole circumference so the arc vanishes
-        return std::vector<CircArc>();
+        return;
         
       // second arc is a null arc (I have to do nothing)
-      if(a2.alpha==0)
-        return std::vector<CircArc>{*this};
+      if(a2.alpha==0){
+        res.push_back(*this);
+        return;
+      }
       
-      if(theta1()!=0){
-        std::vector<CircArc> res = rotate_arc(-theta1()).diff(a2.rotate_arc(-theta1()));
-        for(size_t i=0; i<res.size(); i++)
-          res[i] = res[i].rotate_arc(theta1());
-        return res;
+      const T t1 = theta1();
+      if(t1!=0){
+        // rotating both arcs so that the first one starts from angle 0, then rotating back the result
+        const T cos_t = std::cos(-t1), sin_t = std::sin(-t1);
+        const size_t first = res.size();
+        rotate_arc(cos_t, sin_t).diff(a2.rotate_arc(cos_t, sin_t), res);
+        const T cos_back = std::cos(t1), sin_back = std::sin(t1);
+        for(size_t i=first; i<res.size(); i++)
+          res[i] = res[i].rotate_arc(cos_back, sin_back);
+        return;
       }
       
       // if we arrive here then we have that theta1 of first arc is 0.
+      const T a2_theta1 = a2.theta1(), a2_theta2 = a2.theta2(a2_theta1);
       
       // case 1: 0 < alpha <= a2.theta1 < a2.theta2 (0 < alpha is always true by construction)
-      if( alpha <= a2.theta1() && a2.theta1() < a2.theta2() )
-        return std::vector<CircArc>{*this};
+      if( alpha <= a2_theta1 && a2_theta1 < a2_theta2 ){
+        res.push_back(*this);
+        return;
+      }
       
       // case 2: 0 < a2.theta1 < alpha <= a2.theta2
-      if( 0 < a2.theta1() && a2.theta1() < alpha && alpha <= a2.theta2() )
-        return std::vector<CircArc>{CircArc(b,v,a2.theta1())};
+      if( 0 < a2_theta1 && a2_theta1 < alpha && alpha <= a2_theta2 ){
+        res.push_back(CircArc(b,v,a2_theta1));
+        return;
+      }
       
       // case 3: 0 < a2.theta1 < a2.theta2 < alpha
-      if( 0 < a2.theta1() && a2.theta1() < a2.theta2() && a2.theta2() < alpha){
+      if( 0 < a2_theta1 && a2_theta1 < a2_theta2 && a2_theta2 < alpha){
         // I have to split the arc in two parts
         if( alpha == 2*M_PI ) // sub-special case: instead of two arcs I just form one
-          return std::vector<CircArc>{CircArc(b, a2.getEndVector(), alpha-a2.theta2()+a2.theta1())};
-        // else
-        return std::vector<CircArc>{CircArc(b, v, a2.theta1()), CircArc(b, a2.getEndVector(), alpha-a2.theta2())};
+          res.push_back(CircArc(b, a2.getEndVector(), alpha-a2_theta2+a2_theta1));
+        else{
+          res.push_back(CircArc(b, v, a2_theta1));
+          res.push_back(CircArc(b, a2.getEndVector(), alpha-a2_theta2));
+        }
+        return;
       }
       
       // case 4: 0 = a2.theta1 < alpha <= a2.theta2
-      if( 0 == a2.theta1() && alpha <= a2.theta2() )
-        return std::vector<CircArc>();
+      if( 0 == a2_theta1 && alpha <= a2_theta2 )
+        return;
       
       // case 5: 0 = a2.theta1 < a2.theta2 < alpha 
-      if( 0 == a2.theta1() && a2.theta2() < alpha )
-        return std::vector<CircArc>{CircArc(b, a2.getEndVector(), alpha-a2.theta2())};
+      if( 0 == a2_theta1 && a2_theta2 < alpha ){
+        res.push_back(CircArc(b, a2.getEndVector(), alpha-a2_theta2));
+        return;
+      }
       
       // case 6: 0 < a2.theta2 < alpha <= a2.theta1
-      if( 0 < a2.theta2() && a2.theta2() < alpha && alpha <= a2.theta1() )
-        return std::vector<CircArc>{CircArc(b, a2.getEndVector(), alpha-a2.theta2())};
+      if( 0 < a2_theta2 && a2_theta2 < alpha && alpha <= a2_theta1 ){
+        res.push_back(CircArc(b, a2.getEndVector(), alpha-a2_theta2));
+        return;
+      }
       
       // case 7: 0 < alpha <= a2.theta2 < a2.theta1
-      if(alpha <= a2.theta2() && a2.theta2() < a2.theta1())
-        return std::vector<CircArc>();;
+      if(alpha <= a2_theta2 && a2_theta2 < a2_theta1)
+        return;
       
       // case 8: 0 < a2.theta2 < a2.theta1 <= alpha
-      if(a2.theta2() < a2.theta1() && a2.theta1() <= alpha)
-        return std::vector<CircArc>{CircArc(b, a2.getEndVector(), a2.theta1()-a2.theta2())};
+      if(a2_theta2 < a2_theta1 && a2_theta1 <= alpha){
+        res.push_back(CircArc(b, a2.getEndVector(), a2_theta1-a2_theta2));
+        return;
+      }
       
       // just in case something went wrong...
       std::cerr << "No case match!!" << std::endl;
-      return std::vector<CircArc>();
     };
     
     // Removes from the caller arc the part of it that falls inside the given ball
     std::vector<CircArc> removeBall(const ball& b2) const {
+      std::vector<CircArc> res;
+      removeBall(b2, res);
+      return res;
+    }
+    
+    // Same as above, appending the remaining arcs to res
+    void removeBall(const ball& b2, std::vector<CircArc>& res) const {
       if( b2.containsBall(b) ) // I have to remove the whole arc, nothing remains
-        return std::vector<CircArc>{};
-      if( b.containsBall(b2) ) // I have to remove nothing, the arc remains intact
-        return std::vector<CircArc>{*this};
+        return;
+      if( b.containsBall(b2) ){ // I have to remove nothing, the arc remains intact
+        res.push_back(*this);
+        return;
+      }
       CircArc a2 = b.intersection_arc(b2);
       if( a2.alpha>0 )
-        return diff(a2);
-      return  std::vector<CircArc>{*this};
+        diff(a2, res);
+      else
+        res.push_back(*this);
     }
 };
 
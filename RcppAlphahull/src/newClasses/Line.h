@@ -2,9 +2,10 @@
 #define _LINE_
 
 #include <limits.h>
-#include <ostream>
+#include <iostream>
 #include <cmath>
 #include "../MyGAL/Vector2.h"
+#include "../MyGAL/Predicates.h"
 #include "geomUtil.h"
 using namespace mygal;
 
@@ -28,6 +29,10 @@ class Line{
   // ATTRIBUTES
   private:
     T a,b,c; // a*y + b*x + c = 0 -> m=-b/a and q = -c/a for non vertical lines
+    // for lines built from two points: the points themselves, ordered such that a*y + b*x + c has the sign
+    // of orientation(p1, p2, (x,y)), which allows exact evaluations (see eval)
+    vector2 p1, p2;
+    bool through_points = false;
 
     /* normalizes the line:
      * - a<0 => switches sings of a, b and c
@@ -50,7 +55,13 @@ class Line{
       normalize(); // normalizes the line
     }; // raises an error if both a and b are 0
     Line(const vector2& p1, const vector2& p2): Line(p2.x-p1.x, p1.y-p2.y, p1.x*p2.y-p2.x*p1.y)
-    { if( p1 == p2 ) std::cerr << "Error! p1 and p2 are the same point" << std::endl; };
+    {
+      if( p1 == p2 ) std::cerr << "Error! p1 and p2 are the same point" << std::endl;
+      bool switched = (a != p2.x-p1.x || b != p1.y-p2.y); // normalize() switched the signs
+      this->p1 = switched? p2: p1;
+      this->p2 = switched? p1: p2;
+      through_points = true;
+    };
 
     // GETTERS
     T getA() const { return a; }
@@ -68,8 +79,14 @@ class Line{
      * -  1 => a*y_p + b*x_p + c > 0 ( y_p - (m*x_p + q) > or x_p > x for vertical lines)
      * -  0 => a*y_p + b*x_p + c = 0 ( y_p - (m*x_p + q) = or x_p = x for vertical lines)
      * - -1 => a*y_p + b*x_p + c < 0 ( y_p - (m*x_p + q) < or x_p < x for vertical lines)
+     * For lines built from two points the sign is exact (adaptive orientation predicate), otherwise it is
+     * evaluated with tollerance.
      */
-    int eval(const vector2& p) const{ return sign<T>(a*p.y + b*p.x + c); }
+    int eval(const vector2& p) const{ 
+      if(through_points)
+        return orientation(p1, p2, p);
+      return sign<T>(a*p.y + b*p.x + c); 
+    }
 
     // Provided a x abscissa returns the y coordinate, if the line is vertical and x!=xr then a quite_NaN
     // is returned, otherwise it returns the same value x.
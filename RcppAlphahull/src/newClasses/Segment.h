@@ -1,5 +1,6 @@
 #include "../MyGAL/Vector2.h"
 #include "Line.h"
+#include "../MyGAL/Predicates.h"
 #include <limits>
 #include <ostream>
 using namespace mygal;
@@ -57,17 +58,15 @@ class Segment{
     bool isVertical() const {return p.x == q.x;}
     
     // OTHER METHODS
-    // Returns wheter or not two segment intersect (in R2)
+    // Returns wheter or not two segment intersect (in R2), the positions are evaluated with the exact
+    // orientation predicate
     bool intersect(const Segment<T>& s) const{
-      // retrieving lines
-      line r1=getLine(), r2=s.getLine();
-      
-      // check position of 2nd segment w.r.t. the 1st: if val1 and val2 have different signs then the segment s2 crosses the line r1
-      int val1 = r1.eval(s.p);
-      int val2 = r1.eval(s.q);
-      // check position of 1st segment w.r.t. the 2nd: if val3 and val4 have different signs then the segment s1 crosses the line r2
-      int val3 = r2.eval(p);
-      int val4 = r2.eval(q);
+      // check position of 2nd segment w.r.t. the 1st: if val1 and val2 have different signs then the segment s2 crosses the line through p and q
+      int val1 = orientation(p, q, s.p);
+      int val2 = orientation(p, q, s.q);
+      // check position of 1st segment w.r.t. the 2nd: if val3 and val4 have different signs then the segment s1 crosses the line through s.p and s.q
+      int val3 = orientation(s.p, s.q, p);
+      int val4 = orientation(s.p, s.q, q);
       
       if(val1!=val2 && val3!=val4)
         return true;
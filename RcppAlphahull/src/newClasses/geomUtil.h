@@ -3,9 +3,14 @@
 #ifndef _GEOM_UTIL_
 #define _GEOM_UTIL_
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <list>
+#include <vector>
 #include "../MyGAL/Vector2.h"
 #include "../MyGAL/util.h"
+#include "../parallel.h"
 using namespace mygal;
 
 template<typename T> class Ball;
@@ -56,49 +61,216 @@ T angle_vects(const Vector2<T>& v1, const Vector2<T>& v2){
   return angle;
 };
 
-// Rturns a vectore rotated (counter-clockwise) by the angle theta
+// Returns a vector rotated (counter-clockwise) by the angle whose cosine and sine are given
 template<typename T>
-Vector2<T> rotate(const Vector2<T>& v, const T& theta){
-  T x2 = v.x*std::cos(theta)-v.y*std::sin(theta); 
-  T y2 = v.x*std::sin(theta)+v.y*std::cos(theta); 
+Vector2<T> rotate(const Vector2<T>& v, const T& cos_theta, const T& sin_theta){
+  T x2 = v.x*cos_theta-v.y*sin_theta; 
+  T y2 = v.x*sin_theta+v.y*cos_theta; 
   return Vector2<T>(x2,y2);
 };
 
+// Rturns a vectore rotated (counter-clockwise) by the angle theta
+template<typename T>
+Vector2<T> rotate(const Vector2<T>& v, const T& theta){ return rotate<T>(v, std::cos(theta), std::sin(theta)); };
+
+// Given a vector of arcs, removes from each one the parts in common with the provided ball and stores the
+// new arc parts in res (cleared first, it must not be arcs), so that the same buffers can be reused
+template<typename T>
+void collective_removeBall(const std::vector<CircArc<T>>& arcs, const Ball<T>& b, std::vector<CircArc<T>>& res){
+  res.clear();
+  for(typename std::vector<CircArc<T>>::const_iterator it = arcs.cbegin(); it!=arcs.cend(); it++)
+    it->removeBall(b, res); // subtracting the ball from the current element
+}
+
 // Given a vector of arcs, removes from each one the parts in common with the provided ball returning
 // a vector containing the new arc parts
 template<typename T>
 std::vector<CircArc<T>> collective_removeBall(const std::vector<CircArc<T>>& arcs, const Ball<T>& b){
   std::vector<CircArc<T>> res;
-  
-  for(typename std::vector<CircArc<T>>::const_iterator it = arcs.cbegin(); it!=arcs.cend(); it++){
-    std::vector<CircArc<T>> tmp = it->removeBall(b); // subtracting the ball from the current element
-    res.insert(res.end(), tmp.begin(), tmp.end()); // adding the subtracted arcs to the result
-  }
-  
+  collective_removeBall(arcs, b, res);
   return res;
 }
 
-// Given some balls returns the arcs that form the boundary of the union by removing those arc parts 
-// that are in the interior
+/* Grid over the bounding boxes of some balls, used to find the balls that may intersect a given one without
+ * testing all of them. The boxes are enlarged by some units of roundoff so that two balls that
+ * CircArc::removeBall finds intersecting (or one containing the other) always have overlapping boxes.
+ * 
+ * The balls don't have the same size (the complement of an alpha-hull has a few huge balls near the convex
+ * hull), so the grid has several levels: the cells of level 0 are as large as the median box, the ones of
+ * each next level are twice as large, and each ball is stored in the first level whose cells are at least as
+ * large as its box, i.e. in at most 4 cells. The levels cover the boxes of the balls not much larger than the
+ * median one, the boxes out of them are clamped to the cells on their border.
+ */
 template<typename T>
-std::list<CircArc<T>> union_boundary(const std::vector<Ball<T>>& balls){
-  std::list<CircArc<T>> res;
+class BallGrid{
+  private:
+    // cells of a level, the balls of cell k are ids[start[k]], ..., ids[start[k+1]-1]
+    struct Level{
+      T size; // side of the cells
+      size_t nx, ny; // number of cells along x and y
+      std::vector<size_t> start, ids, members; // members: balls stored in the level
+    };
+  
+    // ATTRIBUTES
+    std::vector<T> xmin, xmax, ymin, ymax; // bounding box of each ball
+    T x0, y0; // origin of the grid
+    std::vector<Level> levels;
+    
+    // index of the cell containing the given coordinate (along one axis), clamped to the level
+    static size_t cell(const T& v, const T& v0, const T& size, size_t n){
+      T k = std::floor((v-v0)/size);
+      return k < 0? 0: (k >= T(n)? n-1: size_t(k));
+    }
+    // range of the cells of level l covered by the box of ball i, returns their number
+    size_t cells(const Level& l, size_t i, size_t& i1, size_t& i2, size_t& j1, size_t& j2) const {
+      i1 = cell(xmin[i], x0, l.size, l.nx);
+      i2 = cell(xmax[i], x0, l.size, l.nx);
+      j1 = cell(ymin[i], y0, l.size, l.ny);
+      j2 = cell(ymax[i], y0, l.size, l.ny);
+      return (i2-i1+1)*(j2-j1+1);
+    }
+    // whether the boxes of balls i and j overlap
+    bool overlap(size_t i, size_t j) const {
+      return xmin[j]<=xmax[i] && xmin[i]<=xmax[j] && ymin[j]<=ymax[i] && ymin[i]<=ymax[j];
+    }
   
-  // for each ball I create the respective arc and then remove the portions inside the other balls
-  for(typename std::vector<Ball<T>>::const_iterator it1=balls.cbegin(); it1!=balls.cend(); it1++){
-    CircArc<T> arc(*it1); // in principle the whole ball boundary has to be included
-    std::vector<CircArc<T>> tmp{arc}; // in this variable I progressively save the results I get by
-                                      // removing the different balls
+  public:
+    // CONSTRUCTORS
+    BallGrid(const std::vector<Ball<T>>& balls): xmin(balls.size()), xmax(balls.size()), ymin(balls.size()),
+                                                 ymax(balls.size()), x0(0), y0(0) {
+      if(balls.empty())
+        return;
+      
+      std::vector<T> width(balls.size());
+      for(size_t i=0; i<balls.size(); i++){
+        Vector2<T> c = balls[i].center();
+        T r = balls[i].radius(), margin = 16*std::numeric_limits<T>::epsilon()*(r+std::fabs(c.x)+std::fabs(c.y));
+        xmin[i] = c.x-r-margin;
+        xmax[i] = c.x+r+margin;
+        ymin[i] = c.y-r-margin;
+        ymax[i] = c.y+r+margin;
+        width[i] = std::max(xmax[i]-xmin[i], ymax[i]-ymin[i]);
+      }
+      
+      std::vector<T> sorted(width);
+      std::nth_element(sorted.begin(), sorted.begin()+sorted.size()/2, sorted.end());
+      const T median = sorted[sorted.size()/2];
+      T x1 = 0, y1 = 0;
+      bool first = true;
+      for(size_t i=0; i<balls.size(); i++)
+        if( width[i] <= 8*median ){
+          x0 = first? xmin[i]: std::min(x0, xmin[i]);
+          x1 = first? xmax[i]: std::max(x1, xmax[i]);
+          y0 = first? ymin[i]: std::min(y0, ymin[i]);
+          y1 = first? ymax[i]: std::max(y1, ymax[i]);
+          first = false;
+        }
+      
+      // cells of level 0 as large as the median box, larger if they would be more than two per ball; the last
+      // level has a single cell
+      T size = std::max(median, std::sqrt((x1-x0)*(y1-y0)/(2*balls.size())));
+      if( !(size > 0) || !std::isfinite(size) )
+        size = std::numeric_limits<T>::infinity();
+      do{
+        Level l;
+        l.size = size;
+        l.nx = std::isfinite(size)? std::min(size_t((x1-x0)/size)+1, 2*balls.size()): 1;
+        l.ny = std::isfinite(size)? std::min(size_t((y1-y0)/size)+1, 2*balls.size()): 1;
+        levels.push_back(l);
+        size *= 2;
+      } while(levels.back().nx*levels.back().ny > 1);
+      
+      for(size_t i=0; i<balls.size(); i++){
+        size_t l = 0;
+        while( l+1<levels.size() && width[i]>levels[l].size )
+          l++;
+        levels[l].members.push_back(i);
+      }
+      
+      // counting the balls of each cell, then storing them
+      size_t i1, i2, j1, j2;
+      for(Level& l : levels){
+        l.start.assign(l.nx*l.ny+1, 0);
+        for(size_t i : l.members){
+          cells(l, i, i1, i2, j1, j2);
+          for(size_t cj=j1; cj<=j2; cj++)
+            for(size_t ci=i1; ci<=i2; ci++)
+              l.start[cj*l.nx+ci+1]++;
+        }
+        for(size_t k=0; k<l.nx*l.ny; k++)
+          l.start[k+1] += l.start[k];
+        l.ids.resize(l.start.back());
+        std::vector<size_t> next(l.start.begin(), l.start.end()-1);
+        for(size_t i : l.members){
+          cells(l, i, i1, i2, j1, j2);
+          for(size_t cj=j1; cj<=j2; cj++)
+            for(size_t ci=i1; ci<=i2; ci++)
+              l.ids[next[cj*l.nx+ci]++] = i;
+        }
+      }
+    }
     
-    typename std::vector<Ball<T>>::const_iterator it2=balls.cbegin();
-    while(it2!=balls.cend() && !tmp.empty()){
-      if( it1!=it2 )
-        tmp = collective_removeBall(tmp, *it2);
-      it2++;
+    // OTHER METHODS
+    /* Stores in res, in increasing order, the indices of the balls other than i whose box overlaps the one of
+     * ball i (at least all the balls that intersect ball i). It doesn't modify the grid, so several threads
+     * can call it at once.
+     */
+    void candidates(size_t i, std::vector<size_t>& res) const {
+      res.clear();
+      size_t i1, i2, j1, j2;
+      for(const Level& l : levels){
+        if( cells(l, i, i1, i2, j1, j2) > l.members.size() ){ // cheaper to take all the balls of the level
+          for(size_t j : l.members)
+            if( j!=i && overlap(i, j) )
+              res.push_back(j);
+          continue;
+        }
+        for(size_t cj=j1; cj<=j2; cj++)
+          for(size_t ci=i1; ci<=i2; ci++)
+            for(size_t k=l.start[cj*l.nx+ci]; k<l.start[cj*l.nx+ci+1]; k++)
+              if( l.ids[k]!=i && overlap(i, l.ids[k]) )
+                res.push_back(l.ids[k]);
+      }
+      // a ball can be stored in several cells
+      std::sort(res.begin(), res.end());
+      res.erase(std::unique(res.begin(), res.end()), res.end());
+    }
+};
+
+// number of balls (or arcs) handed to a thread at once by union_boundary and getArcs
+const size_t union_chunk_size = 64;
+
+// Given some balls returns the arcs that form the boundary of the union by removing those arc parts 
+// that are in the interior. Each ball is only compared with the balls that may intersect it (see BallGrid),
+// in the order in which they are given: the other ones leave the arcs unchanged.
+// The balls are processed in chunks on the given number of threads, the arcs of each chunk are stored
+// apart and then concatenated in the order of the balls, so the result doesn't depend on the threads.
+template<typename T>
+std::vector<CircArc<T>> union_boundary(const std::vector<Ball<T>>& balls, int threads = 1){
+  const BallGrid<T> grid(balls);
+  const size_t nb_chunks = (balls.size()+union_chunk_size-1)/union_chunk_size;
+  std::vector<std::vector<CircArc<T>>> chunks(nb_chunks);
+  
+  parallel_for(nb_chunks, threads, [&](size_t c){
+    std::vector<size_t> candidates;
+    std::vector<CircArc<T>> tmp, next; // in these variables I progressively save the results I get by removing
+                                       // the different balls (reused for all the balls of the chunk)
+    // for each ball I create the respective arc and then remove the portions inside the other balls
+    for(size_t i=c*union_chunk_size; i<std::min(balls.size(), (c+1)*union_chunk_size); i++){
+      tmp.assign(1, CircArc<T>(balls[i])); // in principle the whole ball boundary has to be included
+      
+      grid.candidates(i, candidates);
+      for(size_t k=0; k<candidates.size() && !tmp.empty(); k++){
+        collective_removeBall(tmp, balls[candidates[k]], next);
+        tmp.swap(next);
+      }
+      chunks[c].insert(chunks[c].end(), tmp.begin(), tmp.end());
     }
-    res.insert(res.end(), tmp.begin(), tmp.end());
-  }
+  });
   
+  std::vector<CircArc<T>> res;
+  for(const std::vector<CircArc<T>>& chunk : chunks)
+    res.insert(res.end(), chunk.begin(), chunk.end());
   return res;
 }
 
@@ -0,0 +1,64 @@
+#ifndef _PARALLEL_
+#define _PARALLEL_
+
+// This header defines a minimal fork-join helper built on std::thread. It does not depend on R:
+// the functions run by the workers must not call the R API (no Rcpp vectors, no Rcpp::stop).
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+/* Calls f(i) for every i in [0, n) using at most nb_threads threads, the calling thread included.
+ * Tasks are handed out one at a time so that tasks of different cost are balanced.
+ * If some call throws, the remaining tasks are skipped and the first exception is rethrown
+ * once all the threads are joined.
+ */
+template<typename F>
+void parallel_for(std::size_t n, int nb_threads, F f){
+  std::size_t nb_workers = std::min<std::size_t>(std::max(nb_threads, 1), n);
+  if(nb_workers <= 1){
+    for(std::size_t i=0; i<n; i++)
+      f(i);
+    return;
+  }
+
+  std::atomic<std::size_t> next(0);
+  std::exception_ptr error;
+  std::mutex error_mutex;
+  auto work = [&](){
+    for(std::size_t i=next++; i<n; i=next++){
+      try{
+        f(i);
+      }
+      catch(...){
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if(!error)
+          error = std::current_exception();
+        next = n;
+      }
+    }
+  };
+
+  std::vector<std::thread> workers;
+  for(std::size_t t=1; t<nb_workers; t++){
+    try{
+      workers.emplace_back(work);
+    }
+    catch(const std::system_error&){ // no more threads available: go on with the ones already started
+      break;
+    }
+  }
+  work();
+  for(auto& worker : workers)
+    worker.join();
+
+  if(error)
+    std::rethrow_exception(error);
+}
+
+#endif
@@ -0,0 +1,521 @@
+#ifndef _PARALLEL_DELVOR_
+#define _PARALLEL_DELVOR_
+
+// This header defines the parallel construction of the Voronoi tesselation/Delaunay triangulation used by
+// computeVoronoiRcpp when more than one thread is requested.
+//
+// The sites are split, by abscissa, in vertical strips. Each strip runs the Fortune's algorithm on its own
+// sites plus the sites of the neighbouring strips that are close to it (ghosts), the sites on the convex
+// hull and at the border of the cloud, and the first two sites met by the sweep line. The cells of the sites of the strip are then checked
+// against all the sites: every Voronoi vertex of those cells must be the center of a circle with no site
+// inside (Delaunay condition). The sites found inside a circle are added to the strip and the strip is
+// built again. Since the strip contains the whole convex hull, its unbounded cells are the same as the
+// global ones, so once the check passes the cells of the sites of the strip are exactly the ones of the
+// diagram of all the sites.
+//
+// Each edge is then exported by the strip owning the site on its first side, and the rows are merged
+// following the events of the sweep line that created them: this is the order of the sequential
+// construction, so the mesh is the same, row by row. The same sweep events produce the same vertices,
+// so the coordinates are bitwise equal too.
+//
+// Whenever the result could differ from the sequential one (duplicated or nearly cocircular sites, sweep
+// events that cannot be ordered, too many sites on the convex hull, ...) parallel_delvor gives up and
+// the caller falls back to the sequential construction.
+//
+// Nothing here calls the R API, so the strips can be processed by several threads.
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <unordered_set>
+#include <vector>
+#include "MyGAL/FortuneAlgorithm.h"
+#include "mesh_edge.h"
+#include "parallel.h"
+
+// uniform grid over the sites, used to find the sites inside a circle
+template<typename T>
+class SiteGrid{
+public:
+  SiteGrid(const std::vector<Vector2<T>>& points, const Box<T>& box, T size):
+    points(points), box(box), size(size) {
+    nx = static_cast<std::size_t>((box.right-box.left)/size) + 1;
+    ny = static_cast<std::size_t>((box.top-box.bottom)/size) + 1;
+    // counting sort of the sites by cell
+    start.assign(nx*ny+1, 0);
+    for(const auto& p : points)
+      start[cell(p)+1]++;
+    std::partial_sum(start.begin(), start.end(), start.begin());
+    items.resize(points.size());
+    std::vector<std::size_t> next(start.begin(), start.end()-1);
+    for(std::size_t i=0; i<points.size(); i++)
+      items[next[cell(points[i])]++] = i;
+  }
+
+  // calls f(i) for every site i in the cells intersecting the rectangle [x0, x1] x [y0, y1]
+  template<typename F>
+  void for_each_in(T x0, T x1, T y0, T y1, F f) const {
+    std::size_t i0 = column(x0), i1 = column(x1), j0 = row(y0), j1 = row(y1);
+    for(std::size_t j=j0; j<=j1; j++)
+      for(std::size_t k=start[j*nx+i0]; k<start[j*nx+i1+1]; k++)
+        f(items[k]);
+  }
+
+  // returns the sites in the cells at the border of the cloud: the non empty cells that touch the border of
+  // the grid or an empty cell connected to it
+  std::vector<std::size_t> border_sites() const {
+    auto empty = [&](std::size_t c){ return start[c] == start[c+1]; };
+    // flood fill of the empty cells from the border of the grid
+    std::vector<bool> outside(nx*ny, false);
+    std::vector<std::size_t> stack;
+    auto visit = [&](std::size_t i, std::size_t j){
+      std::size_t c = j*nx+i;
+      if(empty(c) && !outside[c]){
+        outside[c] = true;
+        stack.push_back(c);
+      }
+    };
+    for(std::size_t i=0; i<nx; i++){
+      visit(i, 0);
+      visit(i, ny-1);
+    }
+    for(std::size_t j=0; j<ny; j++){
+      visit(0, j);
+      visit(nx-1, j);
+    }
+    while(!stack.empty()){
+      std::size_t i = stack.back()%nx, j = stack.back()/nx;
+      stack.pop_back();
+      if(i > 0) visit(i-1, j);
+      if(i+1 < nx) visit(i+1, j);
+      if(j > 0) visit(i, j-1);
+      if(j+1 < ny) visit(i, j+1);
+    }
+
+    std::vector<std::size_t> border;
+    for(std::size_t j=0; j<ny; j++)
+      for(std::size_t i=0; i<nx; i++){
+        bool at_border = i == 0 || j == 0 || i+1 == nx || j+1 == ny;
+        for(std::size_t jj=j-1; !at_border && jj!=j+2; jj++)
+          for(std::size_t ii=i-1; !at_border && ii!=i+2; ii++)
+            at_border = outside[jj*nx+ii];
+        std::size_t c = j*nx+i;
+        if(at_border && !empty(c))
+          border.insert(border.end(), items.begin()+start[c], items.begin()+start[c+1]);
+      }
+    return border;
+  }
+
+private:
+  const std::vector<Vector2<T>>& points;
+  Box<T> box;
+  T size;
+  std::size_t nx, ny;
+  std::vector<std::size_t> start; // sites of cell c are items[start[c]], ..., items[start[c+1]-1]
+  std::vector<std::size_t> items;
+
+  std::size_t column(T x) const {
+    if(!(x > box.left)) return 0;
+    return std::min(static_cast<std::size_t>((x-box.left)/size), nx-1);
+  }
+  std::size_t row(T y) const {
+    if(!(y > box.bottom)) return 0;
+    return std::min(static_cast<std::size_t>((y-box.bottom)/size), ny-1);
+  }
+  std::size_t cell(const Vector2<T>& p) const {
+    return row(p.y)*nx + column(p.x);
+  }
+};
+
+// Returns the sites on the boundary of the convex hull (Andrew's monotone chain on the sites sorted by
+// abscissa). Nearly collinear sites are kept on the chains, so some sites close to the boundary may be
+// returned too, but none of the sites lying on the boundary is missed.
+template<typename T>
+std::vector<std::size_t> hull_sites(const std::vector<Vector2<T>>& points, const std::vector<std::size_t>& order,
+                                    T tol){
+  auto turn = [&](std::size_t o, std::size_t a, std::size_t b){
+    return (points[a]-points[o]).getDet(points[b]-points[o]);
+  };
+  std::vector<std::size_t> lower, upper;
+  for(auto it=order.cbegin(); it!=order.cend(); it++){
+    while(lower.size()>=2 && turn(lower[lower.size()-2], lower.back(), *it) < -tol)
+      lower.pop_back();
+    lower.push_back(*it);
+  }
+  for(auto it=order.crbegin(); it!=order.crend(); it++){
+    while(upper.size()>=2 && turn(upper[upper.size()-2], upper.back(), *it) < -tol)
+      upper.pop_back();
+    upper.push_back(*it);
+  }
+  lower.insert(lower.end(), upper.begin(), upper.end());
+  std::sort(lower.begin(), lower.end());
+  lower.erase(std::unique(lower.begin(), lower.end()), lower.end());
+  return lower;
+}
+
+// Returns if the event a comes strictly before the event b in the sweep of the Fortune's algorithm
+// (higher first, then rightmost first, a site before a circle event at the same position)
+template<typename E>
+bool sweep_before(const E& a, const E& b){
+  if(a.y != b.y) return a.y > b.y;
+  if(a.x != b.x) return a.x > b.x;
+  return a.site && !b.site;
+}
+
+// sites and partial results of a strip
+template<typename T>
+struct DelvorStrip{
+  typedef typename FortuneAlgorithm<T>::EdgeEvent EdgeEvent;
+
+  std::vector<std::size_t> ids;            // global indices of the sites of the strip, owned sites first
+  std::size_t nb_owned;
+  std::size_t ghost_begin, ghost_end;      // ranks in abscissa order of the owned sites and of the ghosts
+  T band_left, band_right;                 // abscissae of the owned sites and of the ghosts
+  std::unordered_set<std::size_t> extras;  // sites not in the ghost range and not on the border
+  std::unique_ptr<FortuneAlgorithm<T>> algorithm;
+  std::vector<EdgeEvent> events;           // event creating each edge of the diagram
+  Box<T> vertices_box;                     // smallest box containing the vertices of the owned cells
+  std::vector<MeshEdge<T>> rows;           // edges whose first site is owned, in sweep order
+  std::vector<EdgeEvent> rows_events;
+};
+
+// shared read-only data of the construction
+template<typename T>
+struct DelvorSites{
+  const std::vector<Vector2<T>>& points;
+  std::vector<std::size_t> rank;           // position of each site in abscissa order
+  std::vector<bool> on_border;             // convex hull and sites at the border of the cloud
+  SiteGrid<T> grid;
+};
+
+template<typename T>
+T squared_distance(const Vector2<T>& a, const Vector2<T>& b){
+  return (a.x-b.x)*(a.x-b.x) + (a.y-b.y)*(a.y-b.y);
+}
+
+// relative tolerance under which two squared distances are considered equal
+template<typename T>
+T cocircular_tolerance(){ return static_cast<T>(1e-9); }
+
+/* Checks the cells of the sites owned by the strip. Returns false if the strip cannot be trusted, otherwise
+ * the sites that are inside the circle of some vertex, and are not in the strip, are stored in conflicts.
+ */
+template<typename T>
+bool check_strip(const DelvorStrip<T>& strip, const DelvorSites<T>& sites, std::vector<std::size_t>& conflicts,
+                 Box<T>& vertices_box){
+  const auto& diagram = strip.algorithm->viewDiagram();
+  const T tol = cocircular_tolerance<T>();
+  auto in_strip = [&](std::size_t i){
+    return (sites.rank[i] >= strip.ghost_begin && sites.rank[i] < strip.ghost_end) || sites.on_border[i] ||
+      strip.extras.count(i) > 0;
+  };
+
+  // the events creating the edges must be totally ordered, otherwise the row order is ambiguous
+  for(std::size_t k=1; k<strip.events.size(); k++)
+    if(!sweep_before(strip.events[k-1], strip.events[k]))
+      return false;
+  if(strip.events.size() != diagram.getNbEdges())
+    return false;
+
+  // the half-edges of the owned cells must be linked in chains around their cell, each cell has at most one
+  // unbounded chain
+  for(std::size_t p=0; p<strip.nb_owned; p++)
+    if(diagram.getFace(p)->outerComponent == nullptr)
+      return false;
+  std::vector<char> unbounded(strip.nb_owned, false);
+  for(const auto& edge : diagram.getHalfEdges()){
+    const auto* he = &edge;
+    std::size_t p = he->incidentFace->site->index;
+    if(p >= strip.nb_owned)
+      continue;
+    if(he->twin == nullptr || he->twin->twin != he)
+      return false;
+    if(he->origin == nullptr){
+      if(unbounded[p])
+        return false;
+      unbounded[p] = true;
+    }
+    else if(he->prev == nullptr || he->prev->next != he || he->prev->destination != he->origin)
+      return false;
+    if(he->destination != nullptr){
+      if(he->next == nullptr || he->next->prev != he || he->next->incidentFace != he->incidentFace ||
+         he->next->twin == nullptr)
+        return false;
+      const auto& center = he->destination->point;
+      vertices_box.left = std::min(center.x, vertices_box.left);
+      vertices_box.bottom = std::min(center.y, vertices_box.bottom);
+      vertices_box.right = std::max(center.x, vertices_box.right);
+      vertices_box.top = std::max(center.y, vertices_box.top);
+
+      // a very short edge means nearly cocircular sites, whose edges may depend on the order of the events
+      T r2 = squared_distance(sites.points[strip.ids[p]], center);
+      if(he->origin != nullptr && squared_distance(he->origin->point, center) <= tol*tol*r2)
+        return false;
+
+      // each vertex is checked once, from the owned site of smallest index
+      std::size_t q = he->twin->incidentFace->site->index, r = he->next->twin->incidentFace->site->index;
+      if(q > p && r > p){
+        std::size_t gp = strip.ids[p], gq = strip.ids[q], gr = strip.ids[r];
+        T q2 = squared_distance(sites.points[gq], center);
+        T s2 = squared_distance(sites.points[gr], center);
+        if(!(std::fabs(q2-r2) <= 1e-6*r2 && std::fabs(s2-r2) <= 1e-6*r2))
+          return false; // the vertex is not the center of the circle through the three sites
+        // all the sites of the band are in the strip: only the parts of the circle out of it are searched
+        bool valid = true;
+        auto check_site = [&](std::size_t i){
+          const auto& site = sites.points[i];
+          if((site.x >= strip.band_left && site.x <= strip.band_right) || i == gp || i == gq || i == gr)
+            return;
+          // d2-r2 = (site-p).(site+p-2*center) is compared with the size of its terms, r times the distance
+          // of the site from p: the vertices next to the convex hull have huge circles, that the sites along
+          // the hull are close to relatively to r2 only
+          T d2 = squared_distance(site, center);
+          T margin = tol*std::sqrt(r2*squared_distance(site, sites.points[gp]));
+          if(d2 > r2+margin)
+            return;
+          // a nearly cocircular site of the strip was seen by the Fortune's algorithm as in the sequential
+          // construction
+          if(d2 >= r2-margin){
+            if(!in_strip(i))
+              valid = false; // nearly cocircular site that the strip missed
+          }
+          else if(in_strip(i))
+            valid = false; // wrong triangulation of the strip
+          else
+            conflicts.push_back(i);
+        };
+        T radius = std::sqrt(r2)*(1+tol);
+        if(center.x-radius < strip.band_left)
+          sites.grid.for_each_in(center.x-radius, std::min(strip.band_left, center.x+radius),
+                                 center.y-radius, center.y+radius, check_site);
+        if(center.x+radius > strip.band_right)
+          sites.grid.for_each_in(std::max(strip.band_right, center.x-radius), center.x+radius,
+                                 center.y-radius, center.y+radius, check_site);
+        if(!valid)
+          return false;
+      }
+    }
+  }
+  return true;
+}
+
+/* Builds the diagram of a strip, adding the missing sites until its owned cells are correct. Returns false if
+ * the strip cannot be trusted, or as soon as failed is set by another strip: the construction is then done
+ * sequentially anyway.
+ */
+template<typename T>
+bool build_strip(DelvorStrip<T>& strip, const DelvorSites<T>& sites, const std::atomic<bool>& failed){
+  const int max_rounds = 8;
+  const T inf = std::numeric_limits<T>::infinity();
+  for(int round=0; round<max_rounds && !failed; round++){
+    std::vector<Vector2<T>> points;
+    points.reserve(strip.ids.size());
+    for(auto i : strip.ids)
+      points.push_back(sites.points[i]);
+    strip.events.clear();
+    strip.events.reserve(3*points.size());
+    strip.algorithm.reset(new FortuneAlgorithm<T>(std::move(points)));
+    strip.algorithm->setEdgeEventLog(&strip.events);
+    strip.algorithm->construct();
+    if(failed)
+      return false;
+
+    std::vector<std::size_t> conflicts;
+    strip.vertices_box = Box<T>{inf, inf, -inf, -inf};
+    if(!check_strip(strip, sites, conflicts, strip.vertices_box))
+      return false;
+    if(conflicts.empty())
+      return true;
+    std::sort(conflicts.begin(), conflicts.end());
+    conflicts.erase(std::unique(conflicts.begin(), conflicts.end()), conflicts.end());
+    for(auto i : conflicts){
+      strip.extras.insert(i);
+      strip.ids.push_back(i);
+    }
+  }
+  return false;
+}
+
+/* Parallel version of the construction done by computeVoronoiRcpp: on success emits the rows of the mesh
+ * and fills neighbours exactly as the sequential construction would (bounding box enlarged by dist, indices
+ * starting from 0) and returns true. The rows are emitted from the calling thread, once the result is known
+ * to be valid, by calling mesh.allocate(nb_rows) and then mesh(k, edge) for each row k.
+ * Returns false, leaving the outputs untouched, when the construction has to be done sequentially (too few
+ * sites for nb_threads threads or input for which the result could differ).
+ */
+template<typename T, typename W>
+bool parallel_delvor(const std::vector<Vector2<T>>& points, int nb_threads, T dist, Box<T>& box,
+                     W& mesh, std::vector<std::vector<std::size_t>>& neighbours){
+  typedef typename FortuneAlgorithm<T>::EdgeEvent EdgeEvent;
+  const std::size_t min_sites_per_strip = 2000;
+
+  std::size_t n = points.size();
+  std::size_t nb_strips = std::min<std::size_t>(std::max(nb_threads, 1), n/min_sites_per_strip);
+  if(nb_strips < 2)
+    return false;
+
+  // 1. Sort the sites by abscissa
+  std::vector<std::size_t> order(n);
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&](std::size_t i, std::size_t j){
+    return points[i].x < points[j].x || (points[i].x == points[j].x && points[i].y < points[j].y);
+  });
+  for(std::size_t r=1; r<n; r++)
+    if(points[order[r]].x == points[order[r-1]].x && points[order[r]].y == points[order[r-1]].y)
+      return false; // duplicated sites
+  Box<T> sites_box{points[order.front()].x, points[0].y, points[order.back()].x, points[0].y};
+  for(const auto& p : points){
+    sites_box.bottom = std::min(p.y, sites_box.bottom);
+    sites_box.top = std::max(p.y, sites_box.top);
+  }
+  T width = sites_box.right-sites_box.left, height = sites_box.top-sites_box.bottom;
+  if(!(width > 0 && height > 0))
+    return false;
+  T spacing = std::sqrt(width*height/n); // mean distance between neighbouring sites
+
+  // 2. Shared data: ranks, grid and sites that every strip contains. Besides the convex hull, the sites at
+  // the border of the cloud are added when they are not too many: without them the sites of a strip that
+  // are close to the border would be joined to far sites of the hull, and the strip built again
+  std::vector<std::size_t> rank(n);
+  for(std::size_t r=0; r<n; r++)
+    rank[order[r]] = r;
+  SiteGrid<T> grid(points, sites_box, 2*spacing);
+  auto border = hull_sites(points, order, static_cast<T>(1e-12)*(width*width+height*height));
+  if(border.size() > n/(4*nb_strips))
+    return false; // every strip contains the hull, the partition would be useless
+  auto frame = grid.border_sites();
+  if(border.size()+frame.size() <= n/(4*nb_strips)){
+    border.insert(border.end(), frame.begin(), frame.end());
+    std::sort(border.begin(), border.end());
+    border.erase(std::unique(border.begin(), border.end()), border.end());
+  }
+  std::vector<bool> on_border(n, false);
+  for(auto i : border)
+    on_border[i] = true;
+  DelvorSites<T> sites{points, std::move(rank), std::move(on_border), std::move(grid)};
+
+  // the first two sites met by the sweep line define the first edge, every strip needs them
+  auto sweep_order = [&](std::size_t i, std::size_t j){
+    return points[i].y > points[j].y || (points[i].y == points[j].y && points[i].x > points[j].x);
+  };
+  std::size_t first = 0, second = 1;
+  if(sweep_order(second, first))
+    std::swap(first, second);
+  for(std::size_t i=2; i<n; i++)
+    if(sweep_order(i, first)){
+      second = first;
+      first = i;
+    }
+    else if(sweep_order(i, second))
+      second = i;
+
+  // 3. Build the strips: owned sites are consecutive in abscissa order, ghosts are within "margin"
+  T margin = 3*spacing;
+  std::vector<DelvorStrip<T>> strips(nb_strips);
+  for(std::size_t s=0; s<nb_strips; s++){
+    auto& strip = strips[s];
+    std::size_t lo = s*n/nb_strips, hi = (s+1)*n/nb_strips;
+    strip.band_left = points[order[lo]].x-margin;
+    strip.band_right = points[order[hi-1]].x+margin;
+    strip.ghost_begin = std::partition_point(order.begin(), order.begin()+lo, [&](std::size_t i){
+      return points[i].x < strip.band_left; }) - order.begin();
+    strip.ghost_end = std::partition_point(order.begin()+hi, order.end(), [&](std::size_t i){
+      return points[i].x <= strip.band_right; }) - order.begin();
+    strip.nb_owned = hi-lo;
+    for(std::size_t r=lo; r<hi; r++)
+      strip.ids.push_back(order[r]);
+    for(std::size_t r=strip.ghost_begin; r<lo; r++)
+      strip.ids.push_back(order[r]);
+    for(std::size_t r=hi; r<strip.ghost_end; r++)
+      strip.ids.push_back(order[r]);
+    auto in_ghosts = [&](std::size_t i){
+      return sites.rank[i] >= strip.ghost_begin && sites.rank[i] < strip.ghost_end;
+    };
+    for(auto i : border)
+      if(!in_ghosts(i))
+        strip.ids.push_back(i);
+    for(auto i : {first, second})
+      if(!in_ghosts(i) && !sites.on_border[i]){
+        strip.extras.insert(i);
+        strip.ids.push_back(i);
+      }
+  }
+
+  // the first strip that fails stops the others
+  std::atomic<bool> failed(false);
+  parallel_for(nb_strips, nb_threads, [&](std::size_t s){
+    if(!failed && !build_strip(strips[s], sites, failed))
+      failed = true;
+  });
+  if(failed)
+    return false;
+
+  // 4. Bound all the strips with the box that the sequential construction would use
+  Box<T> bounding_box{0, 0, 1, 1};
+  for(const auto& strip : strips){
+    bounding_box.left = std::min(strip.vertices_box.left, bounding_box.left);
+    bounding_box.bottom = std::min(strip.vertices_box.bottom, bounding_box.bottom);
+    bounding_box.right = std::max(strip.vertices_box.right, bounding_box.right);
+    bounding_box.top = std::max(strip.vertices_box.top, bounding_box.top);
+  }
+  bounding_box.left = bounding_box.left - dist;
+  bounding_box.bottom = bounding_box.bottom - dist;
+  bounding_box.right = bounding_box.right + dist;
+  bounding_box.top = bounding_box.top + dist;
+
+  std::vector<std::vector<std::size_t>> tri_neighbours(n);
+  parallel_for(nb_strips, nb_threads, [&](std::size_t s){
+    auto& strip = strips[s];
+    strip.algorithm->boundWith(bounding_box);
+    const auto& diagram = strip.algorithm->viewDiagram();
+    for_each_mesh_edge(diagram, [&](std::size_t k, MeshEdge<T> edge){
+      if(edge.ind1 < strip.nb_owned){
+        edge.ind1 = strip.ids[edge.ind1];
+        edge.ind2 = strip.ids[edge.ind2];
+        strip.rows.push_back(edge);
+        strip.rows_events.push_back(strip.events[k]);
+      }
+    });
+    auto triangulation = diagram.computeTriangulation();
+    for(std::size_t p=0; p<strip.nb_owned; p++){
+      auto& v = tri_neighbours[strip.ids[p]];
+      for(auto q : triangulation.getNeighbors(p))
+        v.push_back(strip.ids[q]);
+    }
+    strip.algorithm.reset();
+  });
+
+  // 5. Merge the rows of the strips in the order of the sweep line
+  std::size_t nb_rows = 0;
+  for(const auto& strip : strips)
+    nb_rows += strip.rows.size();
+  std::vector<std::pair<std::size_t, std::size_t>> rows; // strip and position in the strip of each row
+  rows.reserve(nb_rows);
+  std::vector<std::size_t> next(nb_strips, 0);
+  const EdgeEvent* last = nullptr;
+  for(std::size_t k=0; k<nb_rows; k++){
+    std::size_t best = nb_strips;
+    for(std::size_t s=0; s<nb_strips; s++)
+      if(next[s] < strips[s].rows.size() &&
+         (best == nb_strips || sweep_before(strips[s].rows_events[next[s]], strips[best].rows_events[next[best]])))
+        best = s;
+    const EdgeEvent* event = &strips[best].rows_events[next[best]];
+    if(last != nullptr && !sweep_before(*last, *event))
+      return false; // two edges created by events at the same position
+    rows.push_back(std::make_pair(best, next[best]));
+    last = event;
+    next[best]++;
+  }
+
+  box = bounding_box;
+  mesh.allocate(nb_rows);
+  for(std::size_t k=0; k<nb_rows; k++)
+    mesh(k, strips[rows[k].first].rows[rows[k].second]);
+  neighbours.swap(tri_neighbours);
+  return true;
+}
+
+#endif
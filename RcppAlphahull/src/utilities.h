@@ -5,12 +5,31 @@
 // vectors and Rcpp's vectors.
 
 #include <Rcpp.h>
+#include <functional>
+#include <string>
+#include <unordered_map>
 #include "MyGAL/FortuneAlgorithm.h"
 #include "newClasses/Ball.h"
 #include "newClasses/HalfPlane.h"
+#include "mesh_edge.h"
+#include "mesh_kernels.h"
 using namespace mygal;
 using namespace Rcpp;
 
+/* Floating point representation used by the kernels, chosen from R with the argument "precision":
+ * "long double" (the default, extended precision) or "double" (faster: SSE arithmetic and no conversions).
+ * Each exported function only dispatches to one of the two explicit instantiations of its kernel.
+ */
+enum class Precision{ Double, LongDouble };
+
+inline Precision as_precision(const std::string& precision){
+  if(precision == "double")
+    return Precision::Double;
+  if(precision != "long double")
+    Rcpp::stop("precision must be either \"double\" or \"long double\"");
+  return Precision::LongDouble;
+}
+
 /* Function to translate indices: since in c++ vectors starts from 0 and in R from 1,
  * then indeces of the sites are shifted by a -1 in c++ with respect the
  * correspondent in R
@@ -23,18 +42,43 @@ std::vector<T1> add_one(const std::vector<T2>& v){
   return newvett;
 };
 
-// Returns if the point "point" is at the boundary of the box "box"
-template <typename T>
-bool isboundary(const Vector2<T>& point, const Box<T>& box){
-  T eps = std::numeric_limits<T>::epsilon();  //  EPSILON<T>
-  if( ( std::fabs((point.x-box.left)/box.left) < eps | std::fabs((point.x-box.right)/box.right) < eps  )
-        && point.y <= box.top && point.y >= box.bottom )
-    return true;
-  if( ( std::fabs((point.y-box.top)/box.top) < eps | std::fabs((point.y-box.bottom)/box.bottom) < eps  )
-        && point.x <= box.right && point.x >= box.left )
-    return true;
-  return false;
-}
+/* Matrices of doubles stored by columns, with the same element access as Rcpp::NumericMatrix. They are used
+ * by the code run on worker threads, which cannot use the R API (see parallel.h): MatrixView reads an
+ * existing Rcpp matrix without copying it, DoubleMatrix owns its elements.
+ */
+struct MatrixView{
+  const double* data;
+  int nrow, ncol;
+
+  explicit MatrixView(const Rcpp::NumericMatrix& m):
+    data(m.nrow()*m.ncol() > 0? &m[0]: nullptr), nrow(m.nrow()), ncol(m.ncol()) {}
+  double operator()(int i, int j) const{ return data[i+(std::size_t) j*nrow]; }
+  int rows() const{ return nrow; }
+  int cols() const{ return ncol; }
+};
+
+struct DoubleMatrix{
+  std::vector<double> data;
+  int nrow, ncol;
+
+  DoubleMatrix(int nrow = 0, int ncol = 0): data((std::size_t) nrow*ncol), nrow(nrow), ncol(ncol) {}
+  double& operator()(int i, int j){ return data[i+(std::size_t) j*nrow]; }
+  double operator()(int i, int j) const{ return data[i+(std::size_t) j*nrow]; }
+  int rows() const{ return nrow; }
+  int cols() const{ return ncol; }
+
+  // copy in a new Rcpp matrix, to be called from the main thread
+  Rcpp::NumericMatrix toRcpp() const{
+    Rcpp::NumericMatrix m(nrow, ncol);
+    std::copy(data.begin(), data.end(), m.begin());
+    return m;
+  }
+};
+
+// columns of a mesh matrix, read by the kernels of mesh_kernels.h
+inline MeshColumns mesh_columns(const MatrixView& mesh){ return MeshColumns(mesh.data, mesh.nrow); }
+inline MeshColumns mesh_columns(const Rcpp::NumericMatrix& mesh){ return mesh_columns(MatrixView(mesh)); }
+inline MeshColumns mesh_columns(const DoubleMatrix& mesh){ return MeshColumns(mesh.data.data(), mesh.nrow); }
 
 // given a vector<T> turns it into a new vector of class Rcpp::...
 template<class C, typename T>
@@ -45,17 +89,56 @@ C as(const std::vector<T>& v){
   return new_v;
 }
 
-// provides vector containings balls and halfplanes describing the alpha hull complement
-template<typename T>
-void complement_matrix_to_vectors(const Rcpp::NumericMatrix& complement, 
-                                  std::vector<Ball<T>>& balls, std::vector<HalfPlane<T>>& halfplanes){
+// names of the columns of the mesh matrix of a delvor object
+inline Rcpp::CharacterVector mesh_colnames(){
+  return Rcpp::CharacterVector::create("ind1", "ind2", "x1", "y1", "x2", "y2", "mx1", "my1", "mx2", "my2",
+                                       "bp1", "bp2");
+}
+
+// names of the columns of the matrix describing the complement of an alpha hull
+inline Rcpp::CharacterVector complement_colnames(){
+  return Rcpp::CharacterVector::create("c1", "c2", "r", "ind1", "ind2", "x1", "y1", "x2", "y2", "mx1", "my1",
+                                       "mx2", "my2", "bp1", "bp2", "ind", "v.x", "v.y", "theta");
+}
+
+// center and radius of a ball of the complement of an alpha hull, as stored in the matrix
+struct ComplementBallKey{
+  double c1, c2, r;
+  bool operator==(const ComplementBallKey& k) const { return c1==k.c1 && c2==k.c2 && r==k.r; }
+};
+
+struct ComplementBallHash{
+  std::size_t operator()(const ComplementBallKey& k) const {
+    std::hash<double> h;
+    std::size_t seed = h(k.c1);
+    seed ^= h(k.c2)+0x9e3779b9+(seed<<6)+(seed>>2);
+    seed ^= h(k.r)+0x9e3779b9+(seed<<6)+(seed>>2);
+    return seed;
+  }
+};
+
+/* Provides vector containings balls and halfplanes describing the alpha hull complement
+ * (M -> Rcpp::NumericMatrix or one of the matrices above). A ball is the circumcircle of a triangle of the
+ * Delaunay triangulation, so it's found in the rows of several edges: it is inserted once, in the order of its
+ * first row, and ball_of_row[i] is the index in balls of the ball of row i (-1 if the row is a halfplane).
+ */
+template<typename T, typename M>
+void complement_matrix_to_vectors(const M& complement, std::vector<Ball<T>>& balls,
+                                  std::vector<HalfPlane<T>>& halfplanes, std::vector<int>& ball_of_row){
+  // index in balls of each ball already inserted, the balls are the same if center and radius are equal
+  std::unordered_map<ComplementBallKey, int, ComplementBallHash> inserted;
+  inserted.reserve(complement.rows());
+  ball_of_row.assign(complement.rows(), -1);
+  
   // constructing balls and halfplanes that form the complement
   for(int i=0; i<complement.rows(); i++)
     if(complement(i,2)>0){ // r > 0 => ball
-      Ball<T> b(complement(i,0), complement(i,1), complement(i,2));
       // it may happen that some balls are inserted more than one time, in those cases I just insert one
-      if( std::find(balls.begin(), balls.end(), b)==balls.end() )
-        balls.push_back(b);
+      ComplementBallKey key{complement(i,0), complement(i,1), complement(i,2)};
+      auto it = inserted.emplace(key, int(balls.size())).first;
+      if( it->second==int(balls.size()) )
+        balls.push_back(Ball<T>(complement(i,0), complement(i,1), complement(i,2)));
+      ball_of_row[i] = it->second;
     }
     else{
       bool side = (complement(i,2) == -1 || complement(i,2) == -3)? true: false; // halfplane has form with ">"
@@ -66,4 +149,12 @@ void complement_matrix_to_vectors(const Rcpp::NumericMatrix& complement,
     }
 }
 
+// Same as above, without the ball of each row
+template<typename T, typename M>
+void complement_matrix_to_vectors(const M& complement, 
+                                  std::vector<Ball<T>>& balls, std::vector<HalfPlane<T>>& halfplanes){
+  std::vector<int> ball_of_row;
+  complement_matrix_to_vectors(complement, balls, halfplanes, ball_of_row);
+}
+
 #endif
\ No newline at end of file
@@ -1,35 +1,111 @@
 #include <Rcpp.h>
 #include <iostream>
 #include <cmath>
+#include <memory>
 #include "MyGAL/FortuneAlgorithm.h"
 #include "utilities.h"
+#include "parallel.h"
+#include "parallel_delvor.h"
+#include "delvor_handle.h"
 using namespace mygal;
 
-/*
- * Function to retrieve a delvor object (almost) like the one returned by the alphahull function delvor,
- * but using the c++ library MyGAL
- */
-// [[Rcpp::export(".computeVoronoiRcpp")]]
-Rcpp::List computeVoronoiRcpp(const Rcpp::NumericVector x, const Rcpp::NumericVector y) {
-  // choosing the floating point representation to be used
-  typedef long double real;
+// Writes the rows of the matrix mesh, the number of rows has to be known before writing the first one.
+// Rows are written through the raw data of the matrix, without the R API, so different threads can write
+// different rows at the same time (M -> Rcpp::NumericMatrix or DoubleMatrix)
+template<typename real, typename M = Rcpp::NumericMatrix>
+struct MeshWriter{
+  const std::vector<Vector2<real>>& points; // sites
+  M mesh;
+  double* data = nullptr;                   // column-major content of mesh
+  std::size_t nb_rows = 0;
 
+  void allocate(std::size_t n){
+    mesh = M(n, 12);
+    data = n > 0? &mesh(0,0): nullptr;
+    nb_rows = n;
+  }
+
+  // writes the given edge in the i-th row
+  void operator()(std::size_t i, const MeshEdge<real>& edge) const{
+    double* row = data + i;
+    row[0*nb_rows] = edge.ind1 + 1;
+    row[1*nb_rows] = edge.ind2 + 1;
+    row[2*nb_rows] = points[edge.ind1].x;
+    row[3*nb_rows] = points[edge.ind1].y;
+    row[4*nb_rows] = points[edge.ind2].x;
+    row[5*nb_rows] = points[edge.ind2].y;
+    row[6*nb_rows] = edge.e1.x;
+    row[7*nb_rows] = edge.e1.y;
+    row[8*nb_rows] = edge.e2.x;
+    row[9*nb_rows] = edge.e2.y;
+    row[10*nb_rows] = edge.bp1;
+    row[11*nb_rows] = edge.bp2;
+  }
+};
+
+/* Builds the Voronoi tesselation/Delaunay triangulation of the sites and returns its mesh matrix, without the
+ * names of the columns. With threads > 1 the construction is split in strips built in parallel (see
+ * parallel_delvor.h), the result is the same as the sequential one.
+ * 
+ * real -> floating point representation to be used
+ * M -> type of the mesh (Rcpp::NumericMatrix or DoubleMatrix)
+ * neighbours -> filled with the Delaunay neighbours of each site, indices starting from 0
+ * parallel -> set to true if the strips were built in parallel, false if the construction was sequential
+ */
+template<typename real, typename M>
+M computeMesh(const Rcpp::NumericVector& x, const Rcpp::NumericVector& y, const int threads,
+              std::vector<std::vector<std::size_t>>& neighbours, bool& parallel) {
   // Build the set of sites
   std::vector<Vector2<real>> points;
+  points.reserve(x.size());
   for(int i=0; i<x.size(); i++)
     points.push_back(Vector2<real>(x[i], y[i]));
 
-  // Call of the Fortune's algorithm to build the tesselation and the triangulation:
-  // procedure suggested by the author of the library MyGAL
-  auto algorithm = FortuneAlgorithm<real>(points); // initialize an instance of Fortune's algorithm
-  algorithm.construct();                            // construct the diagram
-
   Box<real> localbox{0, 0, 1, 1}; 
   real dist = 20*std::max( Rcpp::max(x)-Rcpp::min(x), Rcpp::max(y)-Rcpp::min(y) ); // tuning the enlargement of the bounding box
-  algorithm.bound(&localbox, dist);            // Bound the diagram
-  auto diagram = algorithm.getDiagram(); // Get the constructed diagram
-  //diagram.intersect(Box<ftype>{0, 0, 2, 2}); // Compute the intersection between the diagram and a box
-  auto triangulation = diagram.computeTriangulation();
+
+  // the rows of the matrix mesh (contains Delaunay/voronoi information) are written straight in it
+  MeshWriter<real, M> writer{points, M()};
+  parallel = threads > 1 && parallel_delvor(points, threads, dist, localbox, writer, neighbours);
+  if(!parallel){
+    // Call of the Fortune's algorithm to build the tesselation and the triangulation:
+    // procedure suggested by the author of the library MyGAL
+    FortuneAlgorithm<real> algorithm(points); // initialize an instance of Fortune's algorithm
+    algorithm.construct();                            // construct the diagram
+
+    algorithm.bound(&localbox, dist);            // Bound the diagram
+    auto diagram = algorithm.getDiagram(); // Get the constructed diagram
+    //diagram.intersect(Box<ftype>{0, 0, 2, 2}); // Compute the intersection between the diagram and a box
+    auto triangulation = diagram.computeTriangulation();
+
+    // the edges are read from the edge table of the diagram, in chunks of rows written by different threads
+    std::size_t nb_edges = diagram.getNbEdges();
+    std::size_t nb_chunks = nb_edge_chunks(nb_edges, threads);
+    writer.allocate(nb_edges);
+    parallel_for(nb_chunks, threads, [&](std::size_t c){
+      for_each_mesh_edge(diagram, writer, c*nb_edges/nb_chunks, (c+1)*nb_edges/nb_chunks);
+    });
+    neighbours.resize(x.size());
+    for(size_t i=0; i<x.size(); i++)
+      neighbours[i] = triangulation.getNeighbors(i);
+  }
+
+  return writer.mesh;
+}
+
+/*
+ * Function to retrieve a delvor object (almost) like the one returned by the alphahull function delvor,
+ * but using the c++ library MyGAL (see computeMesh).
+ * 
+ * real -> floating point representation to be used
+ */
+template<typename real>
+Rcpp::List computeVoronoiKernel(const Rcpp::NumericVector& x, const Rcpp::NumericVector& y, const int threads) {
+  std::vector<std::vector<std::size_t>> neighbours;   // Delaunay neighbours of each site
+  bool parallel;
+  Rcpp::NumericMatrix mesh = computeMesh<real, Rcpp::NumericMatrix>(x, y, threads, neighbours, parallel);
+  colnames(mesh) = mesh_colnames();
+  rownames(mesh) = Rcpp::CharacterVector(mesh.nrow(), "");
 
   // Extract information and generate the R object
   // 1. Construct the matrix of coordinates
@@ -37,53 +113,7 @@ Rcpp::List computeVoronoiRcpp(const Rcpp::NumericVector x, const Rcpp::NumericVe
   coord(_, 0) = x;
   coord(_, 1) = y;
 
-  // 2. Construct the matrix mesh (contains Delaunay/voronoi information)
-  auto halfedges = diagram.getHalfEdges();
-  
-  std::vector<int> ind1, ind2, bp1, bp2;
-  std::vector<real>  x1, y1, x2, y2, mx1, my1, mx2, my2;
-  
-  for(auto it = halfedges.begin(); it->twin != nullptr; it++){
-    ind1.push_back(it->incidentFace->site->index + 1);
-    ind2.push_back(it->twin->incidentFace->site->index + 1);
-    
-    x1.push_back(it->incidentFace->site->point.x);
-    y1.push_back(it->incidentFace->site->point.y);
-    x2.push_back(it->twin->incidentFace->site->point.x);
-    y2.push_back(it->twin->incidentFace->site->point.y);
-    
-    mx1.push_back(it->destination->point.x);
-    my1.push_back(it->destination->point.y);
-    mx2.push_back(it->origin->point.x);
-    my2.push_back(it->origin->point.y);
-    
-    bp1.push_back(isboundary(Vector2<real>(it->destination->point.x, it->destination->point.y), localbox));
-    bp2.push_back(isboundary(Vector2<real>(it->origin->point.x, it->origin->point.y), localbox));
-    
-    // luckily, twin halfedges are stored one after the other so I just need
-    // to skip the subsequent halfedge to not include the same information twice
-    it++;
-  }
-
-  Rcpp::CharacterVector names{"ind1", "ind2", "x1", "y1", "x2", "y2", "mx1", "my1", "mx2", "my2", "bp1", "bp2"};
-  Rcpp::NumericMatrix mesh(ind1.size(), names.size());
-  colnames(mesh) = names;
-  rownames(mesh) = Rcpp::CharacterVector(ind1.size(), "");
-
-  std::copy(ind1.cbegin(), ind1.cend(), mesh(_,0).begin());
-  std::copy(ind2.cbegin(), ind2.cend(), mesh(_,1).begin());
-  std::copy(x1.cbegin(), x1.cend(), mesh(_,2).begin());
-  std::copy(y1.cbegin(), y1.cend(), mesh(_,3).begin());
-  std::copy(x2.cbegin(), x2.cend(), mesh(_,4).begin());
-  std::copy(y2.cbegin(), y2.cend(), mesh(_,5).begin());
-  std::copy(mx1.cbegin(), mx1.cend(), mesh(_,6).begin());
-  std::copy(my1.cbegin(), my1.cend(), mesh(_,7).begin());
-  std::copy(mx2.cbegin(), mx2.cend(), mesh(_,8).begin());
-  std::copy(my2.cbegin(), my2.cend(), mesh(_,9).begin());
-  std::copy(bp1.cbegin(), bp1.cend(), mesh(_,10).begin());
-  std::copy(bp2.cbegin(), bp2.cend(), mesh(_,11).begin());
-
-  // 3. Construct the tri object
+  // 2. Construct the tri object
   // original tri object stores infromation about triangulation in a strange way
   // with pointers. I decided to go for a more intuitive way by creating a list
 
@@ -92,7 +122,7 @@ Rcpp::List computeVoronoiRcpp(const Rcpp::NumericVector x, const Rcpp::NumericVe
    */
   Rcpp::List neighbors(x.size());
   for(size_t i=0; i<x.size(); i++){
-    auto tmp = triangulation.getNeighbors(i); // retrieve information about neighbours
+    auto& tmp = neighbours[i];
     std::for_each(tmp.begin(), tmp.end(), [](size_t& val){ val=val+1; }); // adding one to each index
     neighbors[i] = as<Rcpp::IntegerVector>(tmp); // transforming into a Rcpp:IntegerVector
   }
@@ -108,6 +138,54 @@ Rcpp::List computeVoronoiRcpp(const Rcpp::NumericVector x, const Rcpp::NumericVe
                                       Rcpp::Named("x") = coord,
                                       Rcpp::Named("tri.obj") = tri);
   res.attr("class") = "delvor";
+  res.attr("parallel") = parallel; // read and removed by delvor
 
   return res;
 }
+
+template Rcpp::List computeVoronoiKernel<double>(const Rcpp::NumericVector&, const Rcpp::NumericVector&, const int);
+template Rcpp::List computeVoronoiKernel<long double>(const Rcpp::NumericVector&, const Rcpp::NumericVector&, const int);
+
+/* Same construction as computeVoronoiKernel, but the result is kept in a native delvor object (see
+ * delvor_handle.h) returned to R as an external pointer of class "delvorhandle"
+ * 
+ * real -> floating point representation to be used by the construction and by the kernels using the handle
+ */
+template<typename real>
+SEXP computeVoronoiHandleKernel(const Rcpp::NumericVector& x, const Rcpp::NumericVector& y, const int threads,
+                                const std::string& precision) {
+  std::unique_ptr<DelvorHandle<real>> handle(new DelvorHandle<real>());
+  bool parallel;
+  handle->mesh = computeMesh<real, DoubleMatrix>(x, y, threads, handle->neighbours, parallel);
+  handle->x.assign(x.begin(), x.end());
+  handle->y.assign(y.begin(), y.end());
+  computeHandleCache(*handle, threads);
+
+  Rcpp::XPtr<DelvorHandle<real>> ptr(handle.release(), true, handle_tag(precision));
+  ptr.attr("class") = "delvorhandle";
+  ptr.attr("precision") = precision;
+  ptr.attr("parallel") = parallel; // read and removed by delvor
+  return ptr;
+}
+
+// [[Rcpp::export(".computeVoronoiRcpp")]]
+Rcpp::List computeVoronoiRcpp(const Rcpp::NumericVector x, const Rcpp::NumericVector y, const int threads = 1,
+                              const std::string precision = "long double") {
+  if(as_precision(precision) == Precision::Double)
+    return computeVoronoiKernel<double>(x, y, threads);
+  return computeVoronoiKernel<long double>(x, y, threads);
+}
+
+// [[Rcpp::export(".computeVoronoiHandleRcpp")]]
+SEXP computeVoronoiHandleRcpp(const Rcpp::NumericVector x, const Rcpp::NumericVector y, const int threads = 1,
+                              const std::string precision = "long double") {
+  if(as_precision(precision) == Precision::Double)
+    return computeVoronoiHandleKernel<double>(x, y, threads, precision);
+  return computeVoronoiHandleKernel<long double>(x, y, threads, precision);
+}
+
+// precision with which a delvor handle was built
+// [[Rcpp::export(".delvorHandlePrecision")]]
+std::string delvorHandlePrecision(SEXP handle) {
+  return handle_precision(handle) == Precision::Double? "double": "long double";
+}
@@ -0,0 +1,129 @@
+// this benchmark compares the storage used by MyGAL's Diagram for vertices and half-edges (chunked
+// Arena) with the std::list backend it replaced
+//
+// for each number of sites the Voronoi diagram of n random points of [0;1]x[0;1] is built once to know
+// how many vertices/half-edges a real diagram contains, then both backends are filled with the same
+// number of elements (in the same order as Fortune's algorithm does) and walked like the exporter of
+// computeVoronoiRcpp does. Allocation counts are obtained by replacing the global operator new.
+//
+// compile and run from this folder with:
+//   g++ -std=c++14 -O2 -I../RcppAlphahull/src bench_diagram_storage.cpp -o bench_diagram_storage
+//   ./bench_diagram_storage
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <list>
+#include <new>
+#include <random>
+#include <vector>
+#include "MyGAL/FortuneAlgorithm.h"
+using namespace mygal;
+
+static std::size_t nb_allocations = 0;
+
+void* operator new(std::size_t size){
+  ++nb_allocations;
+  if(void* p = std::malloc(size))
+    return p;
+  throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+typedef double real;
+typedef Diagram<real>::Vertex Vertex;
+typedef Diagram<real>::HalfEdge HalfEdge;
+
+struct Measure{
+  double seconds;
+  std::size_t allocations;
+};
+
+// runs f and measures elapsed time and number of allocations (deallocations included in the time)
+template<typename F>
+Measure measure(F f){
+  std::size_t start_alloc = nb_allocations;
+  auto start = std::chrono::steady_clock::now();
+  f();
+  auto end = std::chrono::steady_clock::now();
+  return Measure{std::chrono::duration<double>(end-start).count(), nb_allocations-start_alloc};
+}
+
+// sums the coordinates of the half-edges destinations as the exporter in voronoi_Rcpp.cpp does
+template<typename C>
+real walk(const C& halfedges){
+  real sum = 0;
+  for(auto it=halfedges.begin(); it!=halfedges.end(); it++)
+    if(it->destination!=nullptr)
+      sum+=it->destination->point.x;
+  return sum;
+}
+
+int main(){
+  std::mt19937 gen(3);
+  std::uniform_real_distribution<real> unif(0,1);
+
+  std::printf("%9s %10s %10s | %12s %10s | %12s %10s | %10s %12s\n", "n", "vertices", "halfedges",
+              "list allocs", "list s", "arena allocs", "arena s", "fortune s", "fortune allocs");
+  for(std::size_t n : {10000, 100000, 1000000}){
+    std::vector<Vector2<real>> points;
+    for(std::size_t i=0; i<n; i++)
+      points.push_back(Vector2<real>(unif(gen), unif(gen)));
+
+    // real diagram, also gives the number of elements to store
+    std::size_t nb_vertices = 0, nb_halfedges = 0;
+    Measure fortune = measure([&](){
+      FortuneAlgorithm<real> algorithm(points);
+      algorithm.construct();
+      Box<real> box{0, 0, 1, 1};
+      algorithm.bound(&box, 20);
+      auto diagram = algorithm.getDiagram();
+      nb_vertices = diagram.getVertices().size();
+      nb_halfedges = diagram.getHalfEdges().size();
+    });
+
+    // old backend: one node allocation per element
+    real sum_list = 0;
+    Measure list = measure([&](){
+      std::list<Vertex> vertices;
+      std::list<HalfEdge> halfedges;
+      for(std::size_t i=0; i<nb_halfedges; i++){
+        halfedges.emplace_back();
+        if(i<nb_vertices){
+          vertices.emplace_back();
+          vertices.back().point = points[i%n];
+        }
+        halfedges.back().destination = &vertices.back();
+      }
+      sum_list = walk(halfedges);
+    });
+
+    // new backend: reservation sized from the number of sites, as Diagram does
+    real sum_arena = 0;
+    Measure arena = measure([&](){
+      Arena<Vertex> vertices;
+      Arena<HalfEdge> halfedges;
+      vertices.reserve(2*n);
+      halfedges.reserve(6*n);
+      Vertex* last = nullptr;
+      for(std::size_t i=0; i<nb_halfedges; i++){
+        HalfEdge& he = halfedges[halfedges.create()];
+        if(i<nb_vertices){
+          last = &vertices[vertices.create()];
+          last->point = points[i%n];
+        }
+        he.destination = last;
+      }
+      sum_arena = walk(halfedges);
+    });
+
+    if(sum_list!=sum_arena)
+      std::printf("warning: the two backends do not visit the same elements\n");
+    std::printf("%9zu %10zu %10zu | %12zu %10.4f | %12zu %10.4f | %10.4f %12zu\n", n, nb_vertices, nb_halfedges,
+                list.allocations, list.seconds, arena.allocations, arena.seconds, fortune.seconds,
+                fortune.allocations);
+  }
+
+  return 0;
+}
@@ -0,0 +1,68 @@
+// microbenchmark of FortuneAlgorithm::construct(), the sweep that builds the Voronoi diagram
+//
+// for each number of sites, n random points of [0;1]x[0;1] are generated and construct() is timed
+// (bounding and export are not included). The best time over some replications is reported together
+// with the number of heap allocations done by construct(), obtained by replacing the global operator new.
+//
+// compile and run from this folder with:
+//   g++ -std=c++14 -O2 -I../RcppAlphahull/src bench_fortune_construct.cpp -o bench_fortune_construct
+//   ./bench_fortune_construct
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <vector>
+#include "MyGAL/FortuneAlgorithm.h"
+using namespace mygal;
+
+static std::size_t nb_allocations = 0;
+
+void* operator new(std::size_t size){
+  ++nb_allocations;
+  if(void* p = std::malloc(size))
+    return p;
+  throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+// times construct() on the given points, the construction of the algorithm object is not timed
+template<typename T>
+void bench(const char* type, const std::vector<Vector2<double>>& sites, int replications){
+  std::vector<Vector2<T>> points;
+  for(const auto& p : sites)
+    points.push_back(Vector2<T>(p.x, p.y));
+
+  double best = std::numeric_limits<double>::infinity();
+  std::size_t allocations = 0;
+  for(int r=0; r<replications; r++){
+    FortuneAlgorithm<T> algorithm(points);
+    std::size_t start_alloc = nb_allocations;
+    auto start = std::chrono::steady_clock::now();
+    algorithm.construct();
+    auto end = std::chrono::steady_clock::now();
+    allocations = nb_allocations-start_alloc;
+    best = std::min(best, std::chrono::duration<double>(end-start).count());
+  }
+  std::printf("%12s %9zu %12.4f %14zu\n", type, sites.size(), best, allocations);
+}
+
+int main(){
+  std::mt19937 gen(3);
+  std::uniform_real_distribution<double> unif(0,1);
+
+  std::printf("%12s %9s %12s %14s\n", "type", "n", "construct s", "allocations");
+  for(std::size_t n : {10000, 100000, 1000000}){
+    std::vector<Vector2<double>> sites;
+    for(std::size_t i=0; i<n; i++)
+      sites.push_back(Vector2<double>(unif(gen), unif(gen)));
+    int replications = n<1000000? 5: 2;
+    bench<double>("double", sites, replications);
+    bench<long double>("long double", sites, replications);
+  }
+
+  return 0;
+}
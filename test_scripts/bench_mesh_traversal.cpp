@@ -0,0 +1,177 @@
+// this benchmark compares the traversals of the mesh matrix done by the ashape kernels: the row by row loop
+// they used (12 values far apart from each other read for each edge) with the blocked kernels of
+// mesh_kernels.h, which read the columns as contiguous arrays
+//
+// the mesh of n random points of [0;1]x[0;1] is built with Fortune's algorithm and stored by columns as
+// computeVoronoiRcpp does, then the following passes are timed (best time over some replications):
+// - stream:    sum of the 7 columns read by the kernels, the time needed just to read them from memory;
+// - rows:      interval of alpha of each edge computed row by row, as the old getAlphaNeighbours did;
+// - distances: edgeDistances on the whole mesh, block by block;
+// - intervals: edgeAlphaIntervals, i.e. the blocked version of "rows" (with the AVX2 kernels of mesh_simd.h
+//              for double if available, "no simd" is the same pass with the scalar kernels);
+// - select:    edges of the alpha-shape for alpha = 0.002 (all the sites taken as alpha-extremes) selected
+//              from the intervals computed row by row, as the old computeAshapeKernel did;
+// - shape:     alphaShapeEdges, which only tests the segment intersection for the edges that need it;
+// - output:    edges matrix and length of the alpha-shape built from the rows of "shape", as
+//              computeAshapeKernel did: rows copied one column at a time, then the length computed again
+//              from the copy;
+// - fused:     alphaShapeSelect and copyEdges, the length is summed while the edges are selected.
+// The intervals, the edges and the lengths computed by the two versions must be the same, bit by bit.
+//
+// compile and run from this folder with:
+//   g++ -std=c++14 -O2 -I../RcppAlphahull/src bench_mesh_traversal.cpp -o bench_mesh_traversal
+//   ./bench_mesh_traversal
+
+#include <chrono>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <vector>
+#include "MyGAL/FortuneAlgorithm.h"
+#include "mesh_kernels.h"
+using namespace mygal;
+
+// best time over the replications of f
+template<typename F>
+double best_time(F f, int replications){
+  double best = std::numeric_limits<double>::infinity();
+  for(int r=0; r<replications; r++){
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    best = std::min(best, std::chrono::duration<double>(end-start).count());
+  }
+  return best;
+}
+
+// mesh matrix (stored by columns) of the given sites, filled as MeshWriter in voronoi_Rcpp.cpp does
+std::vector<double> build_mesh(const std::vector<Vector2<double>>& points){
+  FortuneAlgorithm<double> algorithm(points);
+  algorithm.construct();
+  Box<double> box{0, 0, 1, 1};
+  algorithm.bound(&box, 20);
+  auto diagram = algorithm.getDiagram();
+  const auto& edges = diagram.getEdges();
+  std::size_t n = diagram.getNbEdges();
+  std::vector<double> mesh(12*n);
+  for(std::size_t k=0; k<n; k++){
+    const auto* he = edges[k].leftHalfEdge;
+    std::size_t ind1 = he->incidentFace->site->index, ind2 = he->twin->incidentFace->site->index;
+    double* row = mesh.data() + k;
+    row[0*n] = ind1 + 1;
+    row[1*n] = ind2 + 1;
+    row[2*n] = points[ind1].x;
+    row[3*n] = points[ind1].y;
+    row[4*n] = points[ind2].x;
+    row[5*n] = points[ind2].y;
+    row[6*n] = he->destination->point.x;
+    row[7*n] = he->destination->point.y;
+    row[8*n] = he->origin->point.x;
+    row[9*n] = he->origin->point.y;
+    row[10*n] = he->destination->onFrontier;
+    row[11*n] = he->origin->onFrontier;
+  }
+  return mesh;
+}
+
+// interval of alpha of each edge computed row by row
+template<typename T>
+void rows_intervals(const MeshColumns& mesh, T* alpha_min, T* alpha_max){
+  const T inf = std::numeric_limits<T>::infinity();
+  for(std::size_t i=0; i<mesh.rows(); i++){
+    Vector2<T> p(mesh(i,2), mesh(i,3)), q(mesh(i,4), mesh(i,5)), e1(mesh(i,6), mesh(i,7)), e2(mesh(i,8), mesh(i,9));
+    T d1 = mesh(i,10) == 1? inf: p.getDistance(e1);
+    T d2 = mesh(i,11) == 1? inf: p.getDistance(e2);
+    Segment<T> s1(p, q), s2(e1, e2);
+    alpha_min[i] = s1.intersect(s2)? p.getDistance(q)/2: std::min(d1, d2);
+    alpha_max[i] = std::max(d1, d2);
+  }
+}
+
+// whether the two vectors have the same values
+template<typename T>
+bool same_values(const std::vector<T>& a, const std::vector<T>& b){
+  for(std::size_t i=0; i<a.size(); i++)
+    if(a[i] != b[i])
+      return false;
+  return a.size() == b.size();
+}
+
+template<typename T>
+void bench(const char* type, const MeshColumns& mesh, int replications){
+  std::size_t n = mesh.rows();
+  std::vector<T> min1(n), max1(n), min2(n), max2(n), d1(n), d2(n);
+
+  volatile double sink = 0;
+  double stream = best_time([&](){
+    double sum = 0;
+    for(const double* col : {mesh.x1, mesh.y1, mesh.x2, mesh.y2, mesh.mx1, mesh.my1, mesh.mx2})
+      for(std::size_t i=0; i<n; i++)
+        sum += col[i];
+    sink = sum;
+  }, replications);
+  double rows = best_time([&](){ rows_intervals(mesh, min1.data(), max1.data()); }, replications);
+  double distances = best_time([&](){
+    for(std::size_t b=0; b<n; b+=mesh_block_size)
+      edgeDistances(mesh, b, std::min(n, b+mesh_block_size), d1.data()+b, d2.data()+b);
+  }, replications);
+  double intervals = best_time([&](){ edgeAlphaIntervals(mesh, 0, n, min2.data(), max2.data()); }, replications);
+  bool avx2 = simd::enabled();
+  simd::enabled() = false;
+  double scalar = best_time([&](){ edgeAlphaIntervals(mesh, 0, n, min2.data(), max2.data()); }, replications);
+  simd::enabled() = avx2;
+
+  const T alpha = 0.002;
+  std::vector<bool> is_alpha_extreme(n, true); // more than the sites, the indices are all valid
+  std::vector<std::size_t> rows1, rows2;
+  double select = best_time([&](){
+    rows1.clear();
+    rows_intervals(mesh, min1.data(), max1.data());
+    for(std::size_t i=0; i<n; i++)
+      if(min1[i] <= alpha && alpha <= max1[i])
+        rows1.push_back(i);
+  }, replications);
+  double shape = best_time([&](){ rows2 = alphaShapeEdges(mesh, is_alpha_extreme, alpha); }, replications);
+
+  std::vector<double> edges1, edges2;
+  T length1 = 0, length2 = 0;
+  double output = best_time([&](){
+    std::vector<std::size_t> rows = alphaShapeEdges(mesh, is_alpha_extreme, alpha);
+    edges1.assign(12*rows.size(), 0);
+    for(int j=0; j<12; j++)
+      for(std::size_t i=0; i<rows.size(); i++)
+        edges1[i+j*rows.size()] = mesh(rows[i], j);
+    length1 = alphaShapeLength<T>(MeshColumns(edges1.data(), rows.size()));
+  }, replications);
+  double fused = best_time([&](){
+    EdgeMask selected(n);
+    length2 = alphaShapeSelect(mesh, is_alpha_extreme, alpha, selected);
+    edges2.assign(12*selected.count, 0);
+    copyEdges(mesh, selected, edges2.data());
+  }, replications);
+
+  bool same = same_values(min1, min2) && same_values(max1, max2) && rows1 == rows2 && edges1 == edges2 &&
+              length1 == length2;
+  std::printf("%12s %9zu %10.4f %10.4f %10.4f %10.4f %10.4f %10.4f %10.4f %10.4f %10.4f %6s\n", type, n, stream,
+              rows, distances, intervals, scalar, select, shape, output, fused, same? "yes": "NO");
+}
+
+int main(){
+  std::mt19937 gen(3);
+  std::uniform_real_distribution<double> unif(0,1);
+
+  std::printf("%12s %9s %10s %10s %10s %10s %10s %10s %10s %10s %10s %6s\n", "type", "edges", "stream s", "rows s",
+              "dist s", "blocked s", "no simd s", "select s", "shape s", "output s", "fused s", "same");
+  for(std::size_t n : {10000, 100000, 340000}){
+    std::vector<Vector2<double>> points;
+    for(std::size_t i=0; i<n; i++)
+      points.push_back(Vector2<double>(unif(gen), unif(gen)));
+    std::vector<double> data = build_mesh(points);
+    MeshColumns mesh(data.data(), data.size()/12);
+    int replications = n<340000? 10: 5;
+    bench<double>("double", mesh, replications);
+    bench<long double>("long double", mesh, replications);
+  }
+
+  return 0;
+}
@@ -0,0 +1,200 @@
+// stress test of FortuneAlgorithm on degenerate inputs: integer grids, points on a circle, aligned points
+//
+// for each input the diagram is built and bounded as computeVoronoiRcpp does, then the triangles of the
+// dual triangulation (three sites around each vertex of the diagram created by a circle event) are checked
+// with the exact predicates of MyGAL/Predicates.h:
+// - the three sites of a triangle must not be aligned;
+// - no site can be strictly inside the circle through the three sites of a triangle (Delaunay condition).
+// Sites inside such a circle by less than 1e-9 times its radius are only counted as nearly cocircular:
+// four sites that are cocircular before the rounding of their coordinates (e.g. on a decimal lattice) are
+// ordered by the rounded circle events, which the orientation and in-circle predicates can't make exact.
+// The test is repeated with double and long double; a line is printed for each input and the program
+// returns 1 if some check fails.
+//
+// compile and run from this folder with:
+//   g++ -std=c++14 -O2 -I../RcppAlphahull/src stress_test_degenerate.cpp -o stress_test_degenerate
+//   ./stress_test_degenerate
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+#include "MyGAL/FortuneAlgorithm.h"
+#include "MyGAL/Predicates.h"
+using namespace mygal;
+
+typedef std::vector<Vector2<double>> Points;
+
+struct Result{
+  bool bounded;
+  std::size_t triangles, aligned, not_delaunay, cocircular;
+};
+
+// relative distance of p from the circle through a, b and c
+template<typename T>
+T circle_margin(const Vector2<T>& a, const Vector2<T>& b, const Vector2<T>& c, const Vector2<T>& p){
+  T d = 2*(a.x*(b.y-c.y)+b.x*(c.y-a.y)+c.x*(a.y-b.y));
+  T la = a.x*a.x+a.y*a.y, lb = b.x*b.x+b.y*b.y, lc = c.x*c.x+c.y*c.y;
+  Vector2<T> center((la*(b.y-c.y)+lb*(c.y-a.y)+lc*(a.y-b.y))/d, (la*(c.x-b.x)+lb*(a.x-c.x)+lc*(b.x-a.x))/d);
+  T r = center.getDistance(a);
+  return std::fabs(r-center.getDistance(p))/r;
+}
+
+// builds the diagram of the given points and checks its triangles
+template<typename T>
+Result check(const Points& sites){
+  std::vector<Vector2<T>> points;
+  T xmin = sites[0].x, xmax = sites[0].x, ymin = sites[0].y, ymax = sites[0].y;
+  for(const auto& p : sites){
+    points.push_back(Vector2<T>(p.x, p.y));
+    xmin = std::min<T>(xmin, p.x); xmax = std::max<T>(xmax, p.x);
+    ymin = std::min<T>(ymin, p.y); ymax = std::max<T>(ymax, p.y);
+  }
+
+  FortuneAlgorithm<T> algorithm(points);
+  algorithm.construct();
+  T dist = 20*std::max(xmax-xmin, ymax-ymin);
+  Box<T> box{0, 0, 1, 1};
+  Result res{algorithm.bound(&box, dist), 0, 0, 0, 0};
+  auto diagram = algorithm.getDiagram();
+
+  // vertices on the frontier of the box are created by the bounding, not by circle events
+  auto on_frontier = [&](const Vector2<T>& v){
+    return v.x <= box.left || v.x >= box.right || v.y <= box.bottom || v.y >= box.top;
+  };
+
+  std::set<std::vector<std::size_t>> triangles;
+  for(const auto& face : diagram.getFaces()){
+    auto he = face.outerComponent;
+    if(he == nullptr)
+      continue;
+    do{
+      if(he->destination != nullptr && he->twin != nullptr && he->next != nullptr && he->next->twin != nullptr
+         && !on_frontier(he->destination->point)){
+        std::vector<std::size_t> ids{face.site->index, he->twin->incidentFace->site->index,
+                                     he->next->twin->incidentFace->site->index};
+        std::sort(ids.begin(), ids.end());
+        triangles.insert(ids);
+      }
+      he = he->next;
+    } while(he != nullptr && he != face.outerComponent);
+  }
+
+  for(const auto& ids : triangles){
+    res.triangles++;
+    Vector2<T> a = points[ids[0]], b = points[ids[1]], c = points[ids[2]];
+    int turn = orientation(a, b, c);
+    if(turn == 0){
+      res.aligned++;
+      continue;
+    }
+    if(turn < 0)
+      std::swap(b, c);
+    for(const auto& p : points)
+      if(inCircle(a, b, c, p) > 0){
+        if(circle_margin(a, b, c, p) < 1e-9)
+          res.cocircular++;
+        else
+          res.not_delaunay++;
+        break;
+      }
+  }
+  return res;
+}
+
+Points grid(int k, double step){
+  Points p;
+  for(int i=0; i<k; i++)
+    for(int j=0; j<k; j++)
+      p.push_back(Vector2<double>(i*step, j*step));
+  return p;
+}
+
+// each site falls on a breakpoint of the two sites above it
+Points hexagonal(int k, double step){
+  Points p;
+  for(int i=0; i<k; i++)
+    for(int j=0; j<k; j++)
+      p.push_back(Vector2<double>(step*(i+0.5*(j%2)), step*j*std::sqrt(3.0)/2));
+  return p;
+}
+
+// n points on a circle (not exactly cocircular in floating point) and its center
+Points circle(int n){
+  Points p{Vector2<double>(0.5, 0.5)};
+  for(int i=0; i<n; i++)
+    p.push_back(Vector2<double>(0.5+0.4*std::cos(2*M_PI*i/n), 0.5+0.4*std::sin(2*M_PI*i/n)));
+  return p;
+}
+
+// integer points exactly on the circle x^2 + y^2 = r^2
+Points integer_circle(int r){
+  Points p;
+  for(int x=-r; x<=r; x++){
+    int y = static_cast<int>(std::lround(std::sqrt(double(r)*r-double(x)*x)));
+    if(double(x)*x+double(y)*y == double(r)*r){
+      p.push_back(Vector2<double>(x, y));
+      if(y != 0)
+        p.push_back(Vector2<double>(x, -y));
+    }
+  }
+  return p;
+}
+
+// n aligned points and two points out of the line
+Points aligned(int n){
+  Points p;
+  for(int i=0; i<n; i++)
+    p.push_back(Vector2<double>(0.1*i, 0.3*0.1*i));
+  p.push_back(Vector2<double>(0.5, 2));
+  p.push_back(Vector2<double>(0.2, -1));
+  return p;
+}
+
+// random points rounded to a coarse lattice, duplicates removed
+Points snapped(int n, double step){
+  std::mt19937 gen(1);
+  std::uniform_real_distribution<double> unif(0,1);
+  std::set<std::pair<double,double>> unique;
+  while((int) unique.size() < n)
+    unique.insert(std::make_pair(std::round(unif(gen)/step)*step, std::round(unif(gen)/step)*step));
+  Points p;
+  for(const auto& q : unique)
+    p.push_back(Vector2<double>(q.first, q.second));
+  return p;
+}
+
+int main(){
+  std::vector<std::pair<std::string, Points>> inputs{
+    {"integer grid 10x10", grid(10, 1)},
+    {"integer grid 40x40", grid(40, 1)},
+    {"grid 40x40 step 0.1", grid(40, 0.1)},
+    {"hexagonal 30x30", hexagonal(30, 1)},
+    {"hexagonal 30x30 step 1e3", hexagonal(30, 1e3)},
+    {"hexagonal 30x30 step 1e-3", hexagonal(30, 1e-3)},
+    {"circle 100 + center", circle(100)},
+    {"circle 1000 + center", circle(1000)},
+    {"integer circle r=5525", integer_circle(5525)},
+    {"aligned 100 + 2", aligned(100)},
+    {"snapped 2000 step 0.02", snapped(2000, 0.02)}
+  };
+
+  bool ok = true;
+  std::printf("%-26s %6s %12s %8s %10s %8s %13s %11s\n", "input", "n", "type", "bounded", "triangles", "aligned",
+              "not delaunay", "cocircular");
+  for(const auto& input : inputs){
+    auto print = [&](const char* type, const Result& res){
+      std::printf("%-26s %6zu %12s %8d %10zu %8zu %13zu %11zu\n", input.first.c_str(), input.second.size(), type,
+                  res.bounded, res.triangles, res.aligned, res.not_delaunay, res.cocircular);
+      ok = ok && res.bounded && res.aligned == 0 && res.not_delaunay == 0;
+    };
+    print("double", check<double>(input.second));
+    print("long double", check<long double>(input.second));
+  }
+  std::printf(ok? "all checks passed\n": "some checks failed\n");
+
+  return ok? 0: 1;
+}
@@ -0,0 +1,165 @@
+// test of the selection of the alpha-shape from the cache of a delvor handle (delvor(handle = TRUE)): the
+// alpha-limits of the sites and the intervals of the edges computed once by computeHandleCache, on several
+// threads, must select the same alpha-extremes and the same edges, with the same length, as the selection that
+// computeAshapeKernel makes from the mesh of a delvor object
+//
+// the mesh of each input is built and bounded as computeVoronoiRcpp does and stored by columns. For each value
+// of alpha the selection from the cache (computeAshapeHandleKernel, and computeAshapesHandleKernel for a vector
+// of values) is compared, bit by bit, with the one computed on the fly on one thread (alphaShapeSelect) and on
+// several threads (alphaShapeEdges). The test is repeated with double and long double; a line is printed for
+// each input and the program returns 1 if some check fails. validity_test_handle.R compares the R objects.
+//
+// compile and run from this folder with:
+//   g++ -std=c++14 -O2 -I../RcppAlphahull/src validity_test_handle_kernels.cpp -o validity_test_handle_kernels -lpthread
+//   ./validity_test_handle_kernels
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+#include "mesh_edge.h"
+#include "mesh_kernels.h"
+
+typedef std::vector<Vector2<double>> Points;
+
+// mesh matrix (stored by columns) of the given sites, filled as MeshWriter in voronoi_Rcpp.cpp does
+template<typename T>
+std::vector<double> build_mesh(const Points& sites){
+  std::vector<Vector2<T>> points;
+  double xmin = sites[0].x, xmax = sites[0].x, ymin = sites[0].y, ymax = sites[0].y;
+  for(const auto& p : sites){
+    points.push_back(Vector2<T>(p.x, p.y));
+    xmin = std::min(xmin, p.x); xmax = std::max(xmax, p.x);
+    ymin = std::min(ymin, p.y); ymax = std::max(ymax, p.y);
+  }
+  FortuneAlgorithm<T> algorithm(points);
+  algorithm.construct();
+  Box<T> box{0, 0, 1, 1};
+  algorithm.bound(&box, 20*std::max(xmax-xmin, ymax-ymin));
+  const auto& diagram = algorithm.viewDiagram();
+  std::size_t n = diagram.getNbEdges();
+  std::vector<double> mesh(12*n);
+  for_each_mesh_edge(diagram, [&](std::size_t k, const MeshEdge<T>& edge){
+    double* row = mesh.data() + k;
+    row[0*n] = edge.ind1 + 1;
+    row[1*n] = edge.ind2 + 1;
+    row[2*n] = points[edge.ind1].x;
+    row[3*n] = points[edge.ind1].y;
+    row[4*n] = points[edge.ind2].x;
+    row[5*n] = points[edge.ind2].y;
+    row[6*n] = edge.e1.x;
+    row[7*n] = edge.e1.y;
+    row[8*n] = edge.e2.x;
+    row[9*n] = edge.e2.y;
+    row[10*n] = edge.bp1;
+    row[11*n] = edge.bp2;
+  });
+  return mesh;
+}
+
+// copy of the given rows of the mesh, stored by columns as the edges of an ashape object
+std::vector<double> mesh_rows(const MeshColumns& mesh, const std::vector<std::size_t>& rows){
+  std::vector<double> edges(12*rows.size());
+  for(int j=0; j<12; j++)
+    for(std::size_t i=0; i<rows.size(); i++)
+      edges[i+j*rows.size()] = mesh(rows[i], j);
+  return edges;
+}
+
+// compares the selections for the given values of alpha, returns the number of mismatches
+template<typename T>
+int check(const Points& sites, const std::vector<T>& alphas, int threads){
+  std::vector<double> data = build_mesh<T>(sites);
+  const MeshColumns mesh(data.data(), data.size()/12);
+  const std::size_t nb_sites = sites.size(), n = mesh.rows();
+
+  // cache of the handle, as computeHandleCache fills it
+  std::vector<T> dist1(n), dist2(n), alpha_min(n), alpha_max(n);
+  edgeAlphaIntervals(mesh, 0, n, alpha_min.data(), alpha_max.data(), dist1.data(), dist2.data(), threads);
+  const std::vector<T> cached_limits = alphaLimits<T>(mesh, nb_sites, threads);
+
+  // computeAshapesHandleKernel: all the values of alpha on worker threads
+  std::vector<std::vector<std::size_t>> handle_extremes(alphas.size()), handle_rows(alphas.size());
+  parallel_for(alphas.size(), threads, [&](std::size_t k){
+    const std::vector<bool> is_alpha_extreme = alphaExtremes(cached_limits, alphas[k], handle_extremes[k]);
+    forEachAlphaShapeEdge(mesh, 0, n, is_alpha_extreme, alphas[k], alpha_min.data(), alpha_max.data(),
+                          [&](std::size_t i){ handle_rows[k].push_back(i); });
+  });
+
+  int mismatches = 0;
+  const std::vector<T> limits = alphaLimits<T>(mesh, nb_sites);
+  for(std::size_t k=0; k<alphas.size(); k++){
+    // computeAshapeKernel on one thread: selection and length in the same pass
+    std::vector<std::size_t> extremes;
+    const std::vector<bool> is_alpha_extreme = alphaExtremes(limits, alphas[k], extremes);
+    EdgeMask selected(n);
+    const T length = alphaShapeSelect<T>(mesh, is_alpha_extreme, alphas[k], selected);
+    std::vector<std::size_t> rows;
+    selected.for_each([&](std::size_t i){ rows.push_back(i); });
+    // computeAshapeKernel on several threads
+    std::vector<std::size_t> threaded_rows = alphaShapeEdges<T>(mesh, is_alpha_extreme, alphas[k], threads);
+    // computeAshapeHandleKernel: length of the copied rows
+    std::vector<double> edges = mesh_rows(mesh, handle_rows[k]);
+    const T handle_length = alphaShapeLength<T>(MeshColumns(edges.data(), handle_rows[k].size()));
+
+    if(extremes != handle_extremes[k] || rows != handle_rows[k] || threaded_rows != rows ||
+       !(length == handle_length))
+      mismatches++;
+  }
+  return mismatches;
+}
+
+Points uniform(std::size_t n, unsigned seed){
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution<double> unif(0, 1);
+  Points p;
+  for(std::size_t i=0; i<n; i++){
+    double x = unif(gen), y = unif(gen);
+    p.push_back(Vector2<double>(x, y));
+  }
+  return p;
+}
+
+Points gaussian_clusters(std::size_t n, unsigned seed){
+  std::mt19937 gen(seed);
+  std::normal_distribution<double> normal(0, 0.05);
+  Points p;
+  for(std::size_t i=0; i<n; i++){
+    double x = (i%3)*0.4 + normal(gen), y = (i%2)*0.3 + normal(gen);
+    p.push_back(Vector2<double>(x, y));
+  }
+  return p;
+}
+
+// perturbed grid, its nearly cocircular sites make the intervals of many edges nearly empty
+Points perturbed_grid(std::size_t side, unsigned seed){
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution<double> unif(-1e-6, 1e-6);
+  Points p;
+  for(std::size_t i=0; i<side; i++)
+    for(std::size_t j=0; j<side; j++)
+      p.push_back(Vector2<double>(i/(double) side + unif(gen), j/(double) side + unif(gen)));
+  return p;
+}
+
+int main(){
+  struct Input{ std::string name; Points sites; };
+  std::vector<Input> inputs = {{"uniform 500", uniform(500, 1)}, {"uniform 20000", uniform(20000, 2)},
+                               {"uniform 200000", uniform(200000, 3)}, {"clusters 20000", gaussian_clusters(20000, 4)},
+                               {"perturbed grid 150x150", perturbed_grid(150, 5)}};
+  std::vector<double> alphas = {0, 0.001, 0.005, 0.01, 0.02, 0.05, 0.1, 0.3, 1, 1e6};
+  bool ok = true;
+  for(const auto& input : inputs)
+    for(int threads : {1, 4}){
+      int mismatches_double = check<double>(input.sites, alphas, threads);
+      int mismatches_long = check<long double>(input.sites,
+                                               std::vector<long double>(alphas.begin(), alphas.end()), threads);
+      std::printf("%-24s %d threads: mismatches double %d, long double %d (of %zu values of alpha)\n",
+                  input.name.c_str(), threads, mismatches_double, mismatches_long, alphas.size());
+      ok = ok && mismatches_double == 0 && mismatches_long == 0;
+    }
+  std::printf(ok? "all checks passed\n": "some checks failed\n");
+  return ok? 0: 1;
+}
@@ -0,0 +1,107 @@
+// validity test of the parallel construction of the Voronoi diagram/Delaunay triangulation (parallel_delvor.h)
+//
+// for each input the diagram is built as computeMesh does, sequentially and with parallel_delvor, and the two
+// results are compared: parallel_delvor must not fall back to the sequential construction (it must return
+// true) and the rows of the mesh, the bounding box and the Delaunay neighbours must be the same, bit by bit.
+// The inputs are uniform points in [0,1]x[0,1] with 1e5, 1e6 and 5e6 sites, and smaller clouds with a 5:1
+// aspect ratio. The elapsed times of both constructions are printed too; the speed up depends on the number
+// of cores of the machine. A line is printed for each input and the program returns 1 if some check fails.
+// The input with 5e6 sites needs about 9 GB of memory: the largest number of sites can be lowered with the
+// second argument.
+//
+// compile and run from this folder with (4 threads and 5e6 sites by default):
+//   g++ -std=c++14 -O2 -I../RcppAlphahull/src validity_test_parallel_delvor.cpp -o validity_test_parallel_delvor -lpthread
+//   ./validity_test_parallel_delvor [threads [max_sites]]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "parallel_delvor.h"
+
+typedef long double real; // default precision of delvor
+
+struct Delvor{
+  Box<real> box;
+  std::vector<MeshEdge<real>> rows;
+  std::vector<std::vector<std::size_t>> neighbours;
+};
+
+// sequential construction, as in computeMesh
+void sequential_delvor(const std::vector<Vector2<real>>& points, real dist, Delvor& res){
+  res.box = Box<real>{0, 0, 1, 1};
+  FortuneAlgorithm<real> algorithm(points);
+  algorithm.construct();
+  algorithm.bound(&res.box, dist);
+  const auto& diagram = algorithm.viewDiagram();
+  auto triangulation = diagram.computeTriangulation();
+  res.rows.resize(diagram.getNbEdges());
+  for_each_mesh_edge(diagram, [&](std::size_t k, const MeshEdge<real>& edge){ res.rows[k] = edge; });
+  res.neighbours.resize(points.size());
+  for(std::size_t i=0; i<points.size(); i++)
+    res.neighbours[i] = triangulation.getNeighbors(i);
+}
+
+bool same_edge(const MeshEdge<real>& a, const MeshEdge<real>& b){
+  return a.ind1 == b.ind1 && a.ind2 == b.ind2 && a.e1.x == b.e1.x && a.e1.y == b.e1.y && a.e2.x == b.e2.x &&
+    a.e2.y == b.e2.y && a.bp1 == b.bp1 && a.bp2 == b.bp2;
+}
+
+// compares the rows emitted by parallel_delvor with the ones of the sequential construction, without storing
+// them (the largest inputs would not fit in memory twice)
+struct MeshComparer{
+  const std::vector<MeshEdge<real>>& expected;
+  bool same;
+  void allocate(std::size_t nb_rows){ same = nb_rows == expected.size(); }
+  void operator()(std::size_t k, const MeshEdge<real>& edge){ same = same && same_edge(expected[k], edge); }
+};
+
+double seconds_since(std::chrono::steady_clock::time_point start){
+  return std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+}
+
+// builds the diagram of n random points in [0,width]x[0,1] both ways and compares the results
+bool check(std::size_t n, double width, int threads, unsigned seed){
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution<double> unif(0, 1);
+  std::vector<Vector2<real>> points;
+  points.reserve(n);
+  for(std::size_t i=0; i<n; i++){
+    double x = width*unif(gen), y = unif(gen);
+    points.push_back(Vector2<real>(x, y));
+  }
+  real dist = 20*std::max<real>(width, 1);
+
+  Delvor sequential;
+  auto start = std::chrono::steady_clock::now();
+  sequential_delvor(points, dist, sequential);
+  double time_sequential = seconds_since(start);
+  Box<real> box{0, 0, 1, 1};
+  MeshComparer mesh{sequential.rows, false};
+  std::vector<std::vector<std::size_t>> neighbours;
+  start = std::chrono::steady_clock::now();
+  bool built = parallel_delvor(points, threads, dist, box, mesh, neighbours);
+  double time_parallel = seconds_since(start);
+
+  bool ok = built && mesh.same && neighbours == sequential.neighbours && box.left == sequential.box.left &&
+    box.bottom == sequential.box.bottom && box.right == sequential.box.right && box.top == sequential.box.top;
+  std::printf("n %8zu width %g: %s  sequential %.3f s, parallel %.3f s (%d threads)\n", n, width,
+              !built? "FALLBACK": ok? "ok": "DIFFERENT", time_sequential, time_parallel, threads);
+  std::fflush(stdout);
+  return ok;
+}
+
+int main(int argc, char** argv){
+  int threads = argc > 1? std::atoi(argv[1]): 4;
+  std::size_t max_sites = argc > 2? std::atof(argv[2]): 5e6;
+  bool ok = true;
+  for(unsigned seed=1; seed<=3; seed++)
+    ok = check(20000, 5, threads, seed) && ok;
+  for(std::size_t n : {100000, 1000000, 5000000})
+    if(n <= max_sites)
+      ok = check(n, 1, threads, 1) && ok;
+  std::printf(ok? "all checks passed\n": "some checks failed\n");
+  return ok? 0: 1;
+}
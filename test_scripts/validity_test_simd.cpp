@@ -0,0 +1,209 @@
+// test of the AVX2 kernels of mesh_simd.h: the alpha intervals of the edges (edgeAlphaIntervals, used by
+// ashape, alphaspectrum and the delvor handle) computed with them must be the same, bit by bit, as the ones
+// computed by the scalar kernels and by the row by row code they replaced
+//
+// the mesh of each input is built and bounded as computeVoronoiRcpp does and stored by columns; besides the
+// inputs of stress_test_degenerate.cpp, a synthetic mesh whose Voronoi edges are nearly aligned with the
+// segments between the sites checks the lanes that the floating point filter of the orientation predicate
+// cannot decide (they are left to the scalar test, "scalar" counts them). A line is printed for each input
+// and the program returns 1 if some check fails; if the processor doesn't support AVX2 only the scalar
+// kernels are compared with the row by row code.
+//
+// compile and run from this folder with:
+//   g++ -std=c++14 -O2 -I../RcppAlphahull/src validity_test_simd.cpp -o validity_test_simd
+//   ./validity_test_simd
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include "MyGAL/FortuneAlgorithm.h"
+#include "mesh_kernels.h"
+using namespace mygal;
+
+typedef std::vector<Vector2<double>> Points;
+
+// mesh matrix (stored by columns) of the given sites, filled as MeshWriter in voronoi_Rcpp.cpp does
+std::vector<double> build_mesh(const Points& points){
+  double xmin = points[0].x, xmax = points[0].x, ymin = points[0].y, ymax = points[0].y;
+  for(const auto& p : points){
+    xmin = std::min(xmin, p.x); xmax = std::max(xmax, p.x);
+    ymin = std::min(ymin, p.y); ymax = std::max(ymax, p.y);
+  }
+  FortuneAlgorithm<double> algorithm(points);
+  algorithm.construct();
+  Box<double> box{0, 0, 1, 1};
+  algorithm.bound(&box, 20*std::max(xmax-xmin, ymax-ymin));
+  auto diagram = algorithm.getDiagram();
+  const auto& edges = diagram.getEdges();
+  std::size_t n = diagram.getNbEdges();
+  std::vector<double> mesh(12*n);
+  for(std::size_t k=0; k<n; k++){
+    const auto* he = edges[k].leftHalfEdge;
+    std::size_t ind1 = he->incidentFace->site->index, ind2 = he->twin->incidentFace->site->index;
+    double* row = mesh.data() + k;
+    row[0*n] = ind1 + 1;
+    row[1*n] = ind2 + 1;
+    row[2*n] = points[ind1].x;
+    row[3*n] = points[ind1].y;
+    row[4*n] = points[ind2].x;
+    row[5*n] = points[ind2].y;
+    row[6*n] = he->destination->point.x;
+    row[7*n] = he->destination->point.y;
+    row[8*n] = he->origin->point.x;
+    row[9*n] = he->origin->point.y;
+    row[10*n] = he->destination->onFrontier;
+    row[11*n] = he->origin->onFrontier;
+  }
+  return mesh;
+}
+
+// n edges whose Voronoi edge lies (up to the rounding) on the line through the sites, or crosses it very
+// close to a site; they are not a real mesh, only the columns read by the kernels matter
+std::vector<double> nearly_aligned(std::size_t n){
+  std::mt19937 gen(2);
+  std::uniform_real_distribution<double> unif(0,1);
+  std::vector<double> mesh(12*n, 0);
+  for(std::size_t k=0; k<n; k++){
+    double* row = mesh.data() + k;
+    double px = unif(gen), py = unif(gen), dx = unif(gen)-0.5, dy = unif(gen)-0.5;
+    double t1 = 3*unif(gen)-1, t2 = 3*unif(gen)-1, eps = (k%3)*1e-17;
+    row[0*n] = 1;
+    row[1*n] = 2;
+    row[2*n] = px;
+    row[3*n] = py;
+    row[4*n] = px+dx;
+    row[5*n] = py+dy;
+    row[6*n] = px+t1*dx;
+    row[7*n] = py+t1*dy+eps;
+    row[8*n] = (k%4 == 0)? px: px+t2*dx;
+    row[9*n] = (k%4 == 0)? py-eps: py+t2*dy;
+    row[10*n] = (k%7 == 0);
+    row[11*n] = (k%11 == 0);
+  }
+  return mesh;
+}
+
+// interval of alpha of each edge computed row by row, as getAlphaNeighbours did before mesh_kernels.h
+void rows_intervals(const MeshColumns& mesh, double* alpha_min, double* alpha_max){
+  const double inf = std::numeric_limits<double>::infinity();
+  for(std::size_t i=0; i<mesh.rows(); i++){
+    Vector2<double> p(mesh(i,2), mesh(i,3)), q(mesh(i,4), mesh(i,5)), e1(mesh(i,6), mesh(i,7)),
+                    e2(mesh(i,8), mesh(i,9));
+    double d1 = mesh(i,10) == 1? inf: p.getDistance(e1);
+    double d2 = mesh(i,11) == 1? inf: p.getDistance(e2);
+    Segment<double> s1(p, q), s2(e1, e2);
+    alpha_min[i] = s1.intersect(s2)? p.getDistance(q)/2: std::min(d1, d2);
+    alpha_max[i] = std::max(d1, d2);
+  }
+}
+
+struct Result{
+  std::size_t edges, scalar;
+  bool same_scalar, same_simd;
+};
+
+Result check(const std::vector<double>& data){
+  MeshColumns mesh(data.data(), data.size()/12);
+  std::size_t n = mesh.rows();
+  Result res{n, 0, false, false};
+  std::vector<double> ref_min(n), ref_max(n), min(n), max(n);
+  rows_intervals(mesh, ref_min.data(), ref_max.data());
+  auto same = [&](){
+    return std::memcmp(ref_min.data(), min.data(), n*sizeof(double)) == 0 &&
+           std::memcmp(ref_max.data(), max.data(), n*sizeof(double)) == 0;
+  };
+
+  bool avx2 = simd::enabled();
+  simd::enabled() = false;
+  edgeAlphaIntervals(mesh, 0, n, min.data(), max.data());
+  res.same_scalar = same();
+  simd::enabled() = avx2;
+  res.same_simd = res.same_scalar;
+#ifdef MESH_SIMD_AVX2
+  if(avx2){
+    std::fill(min.begin(), min.end(), 0);
+    std::fill(max.begin(), max.end(), 0);
+    edgeAlphaIntervals(mesh, 0, n, min.data(), max.data());
+    res.same_simd = same();
+    std::vector<signed char> crosses(n);
+    simd::crossings(mesh.x1, mesh.y1, mesh.x2, mesh.y2, mesh.mx1, mesh.my1, mesh.mx2, mesh.my2, n, crosses.data());
+    res.scalar = std::count(crosses.begin(), crosses.end(), -1);
+  }
+#endif
+  return res;
+}
+
+Points uniform(std::size_t n){
+  std::mt19937 gen(3);
+  std::uniform_real_distribution<double> unif(0,1);
+  Points p;
+  for(std::size_t i=0; i<n; i++)
+    p.push_back(Vector2<double>(unif(gen), unif(gen)));
+  return p;
+}
+
+Points grid(int k, double step){
+  Points p;
+  for(int i=0; i<k; i++)
+    for(int j=0; j<k; j++)
+      p.push_back(Vector2<double>(i*step, j*step));
+  return p;
+}
+
+// each site falls on a breakpoint of the two sites above it
+Points hexagonal(int k, double step){
+  Points p;
+  for(int i=0; i<k; i++)
+    for(int j=0; j<k; j++)
+      p.push_back(Vector2<double>(step*(i+0.5*(j%2)), step*j*std::sqrt(3.0)/2));
+  return p;
+}
+
+// n points on a circle (not exactly cocircular in floating point) and its center
+Points circle(int n){
+  Points p{Vector2<double>(0.5, 0.5)};
+  for(int i=0; i<n; i++)
+    p.push_back(Vector2<double>(0.5+0.4*std::cos(2*M_PI*i/n), 0.5+0.4*std::sin(2*M_PI*i/n)));
+  return p;
+}
+
+// n aligned points and two points out of the line
+Points aligned(int n){
+  Points p;
+  for(int i=0; i<n; i++)
+    p.push_back(Vector2<double>(0.1*i, 0.3*0.1*i));
+  p.push_back(Vector2<double>(0.5, 2));
+  p.push_back(Vector2<double>(0.2, -1));
+  return p;
+}
+
+int main(){
+  std::vector<std::pair<std::string, std::vector<double>>> inputs{
+    {"uniform 1e3", build_mesh(uniform(1000))},
+    {"uniform 1e5", build_mesh(uniform(100000))},
+    {"integer grid 40x40", build_mesh(grid(40, 1))},
+    {"grid 40x40 step 0.1", build_mesh(grid(40, 0.1))},
+    {"hexagonal 30x30", build_mesh(hexagonal(30, 1))},
+    {"hexagonal 30x30 step 1e-3", build_mesh(hexagonal(30, 1e-3))},
+    {"circle 1000 + center", build_mesh(circle(1000))},
+    {"aligned 100 + 2", build_mesh(aligned(100))},
+    {"nearly aligned 1e4 edges", nearly_aligned(10001)}
+  };
+
+  bool ok = true;
+  std::printf("AVX2 kernels: %s\n", simd::enabled()? "yes": "no");
+  std::printf("%-26s %8s %8s %12s %10s\n", "input", "edges", "scalar", "same scalar", "same simd");
+  for(const auto& input : inputs){
+    Result res = check(input.second);
+    std::printf("%-26s %8zu %8zu %12d %10d\n", input.first.c_str(), res.edges, res.scalar, res.same_scalar,
+                res.same_simd);
+    ok = ok && res.same_scalar && res.same_simd;
+  }
+  std::printf(ok? "all checks passed\n": "some checks failed\n");
+
+  return ok? 0: 1;
+}